@@ -1,6 +1,40 @@
-
 #pragma once
+#include <cstdint>
 #include <glm/glm.hpp>
-#include "Chunk.h"
 
+enum class BlockType : uint8_t {
+    Air = 0,
+    Grass = 1,
+    Stone = 2,
+    Dirt = 3,
+    Ore = 4
+};
+
+// Number of BlockType values, Air included
+constexpr int BLOCK_TYPE_COUNT = 5;
+
+enum class RampDirection : uint8_t {
+    None = 0,
+    North = 1,
+    South = 2,
+    East = 3,
+    West = 4,
+    NorthEast = 5,
+    NorthWest = 6,
+    SouthEast = 7,
+    SouthWest = 8
+};
+
+struct Block {
+    BlockType type = BlockType::Air;
+    RampDirection ramp = RampDirection::None;
+
+    bool operator==(const Block& o) const { return type == o.type && ramp == o.ramp; }
+    bool operator!=(const Block& o) const { return !(*this == o); }
+};
+
+// The texture atlas is a row of ATLAS_TILES tiles; getTextureCoordForBlock
+// is the offset of tile getTileIndexForBlock.
+constexpr int ATLAS_TILES = 4;
+int getTileIndexForBlock(BlockType type);
 glm::vec2 getTextureCoordForBlock(BlockType type);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+struct PoolStats {
+    uint64_t requests = 0;
+    uint64_t hits = 0;      // requests served from a free list
+    size_t inUse = 0;
+    size_t highWater = 0;   // most objects live at once
+
+    double hitRate() const { return requests ? (double)hits / (double)requests : 0.0; }
+};
+
+// Process-wide recycler for the packed index buffers behind BlockStorage.
+// Buffers are bucketed by power-of-two word count and kept on free lists
+// after release, so chunk churn stops hitting the general allocator.
+// Optionally buffers are carved from 2 MB huge-page slabs.
+class BlockBufferPool {
+public:
+    static BlockBufferPool& instance();
+
+    // Affects slabs allocated after the call; existing buffers are kept.
+    void setUseHugePages(bool enable);
+
+    // Returns a zeroed buffer of at least `words` words; capacity is written back.
+    uint64_t* acquire(size_t words, size_t& capacity);
+    void release(uint64_t* buf, size_t capacity);
+
+    PoolStats getStats() const;
+
+private:
+    BlockBufferPool() = default;
+    BlockBufferPool(const BlockBufferPool&) = delete;
+    BlockBufferPool& operator=(const BlockBufferPool&) = delete;
+
+    static int sizeClass(size_t words);
+    uint64_t* carveFromSlab(size_t capacity);
+
+    static constexpr size_t SLAB_BYTES = 2 * 1024 * 1024;
+
+    mutable std::mutex mtx;
+    std::vector<std::vector<uint64_t*>> freeLists; // indexed by size class
+    bool hugePages = false;
+
+    std::vector<void*> slabs;   // never returned to the OS
+    char* slabCursor = nullptr;
+    size_t slabRemaining = 0;
+
+    PoolStats stats;
+};
+
+// Owning handle to a pooled buffer; returns it to the pool on destruction.
+class BlockBuffer {
+public:
+    BlockBuffer() = default;
+    explicit BlockBuffer(size_t words);
+    BlockBuffer(const BlockBuffer& o);
+    BlockBuffer(BlockBuffer&& o) noexcept;
+    BlockBuffer& operator=(BlockBuffer o) noexcept;
+    ~BlockBuffer();
+
+    void swap(BlockBuffer& o) noexcept;
+    void clear();
+
+    uint64_t& operator[](size_t i) { return data[i]; }
+    uint64_t operator[](size_t i) const { return data[i]; }
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+
+private:
+    uint64_t* data = nullptr;
+    size_t count = 0;
+    size_t cap = 0;
+};
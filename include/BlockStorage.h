@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Block.h"
+#include "BlockBufferPool.h"
+
+// Palette-compressed voxel storage.
+// Every voxel holds an index into a small palette of distinct block types.
+// Indices are bit-packed into 64-bit words using the narrowest width that can
+// address the whole palette; the width grows as new values are written.
+// A storage whose palette has a single entry keeps no index buffer at all.
+class BlockStorage {
+public:
+    explicit BlockStorage(size_t volume = 0);
+
+    BlockType get(size_t i) const;
+    void set(size_t i, BlockType b);
+
+    // Decode every voxel into out[0, size()), a word of indices at a time.
+    void unpack(BlockType* out) const;
+
+    // Reset every voxel to b and drop the index buffer.
+    void fill(BlockType b);
+
+    size_t size() const { return volume; }
+    int getBitsPerIndex() const { return bits; }
+    const std::vector<BlockType>& getPalette() const { return palette; }
+
+    // Approximate heap bytes held by the palette and index buffer.
+    size_t getMemoryUsage() const;
+
+private:
+    uint32_t findOrAddPaletteEntry(BlockType b);
+    void resize(int newBits);
+
+    uint32_t readIndex(size_t i) const;
+    void writeIndex(size_t i, uint32_t v);
+
+    static int bitsForPaletteSize(size_t n);
+
+    size_t volume;
+    int bits = 0;              // 0 => every voxel is palette[0]
+    int indicesPerWord = 0;
+    std::vector<BlockType> palette;
+    BlockBuffer words;         // pooled; recycled when the storage dies
+};
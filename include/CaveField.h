@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class FastNoiseLite;
+
+// Cave density for one chunk: 3D OpenSimplex2 sampled at (x, 2y, z) in world
+// space. A voxel is carved out where the density exceeds THRESHOLD.
+//
+// Exact evaluates the noise at every voxel asked for. Lattice evaluates it
+// only on a world-aligned grid, every latticeXZ blocks across and latticeY
+// blocks up, and fills the chunk by trilinear interpolation up front, so a
+// lookup is an array read. Neighbouring chunks share the lattice points on
+// their common border, so caves stay seamless.
+//
+// The noise itself comes from a kernel with SEED's configuration fixed at
+// compile time (see CaveNoiseKernel.h), or from FastNoiseLite when Runtime is
+// asked for. Both give the same values.
+class CaveField {
+public:
+    static constexpr int SEED = 54321;
+    static constexpr float FREQUENCY = 0.12f;
+    static constexpr float THRESHOLD = 0.4f;
+    // The noise repeats roughly every 8 blocks across and 4 up, so a 2x1x2
+    // lattice keeps caves close to exact; coarser ones visibly shrink them
+    // (see tools/TerrainBench).
+    static constexpr int LATTICE_XZ = 2;
+    static constexpr int LATTICE_Y = 1;
+
+    enum class Sampling : uint8_t { Exact, Lattice };
+    enum class Kernel : uint8_t { Fixed, Runtime };
+
+    // Field for the w x d columns starting at world (originX, originZ),
+    // queried for local y in [0, maxY]. worldSeed is folded into SEED.
+    CaveField(int worldSeed, int originX, int originZ, int w, int d, int maxY, Sampling sampling,
+              int latticeXZ = LATTICE_XZ, int latticeY = LATTICE_Y, Kernel kernel = Kernel::Fixed);
+    ~CaveField();
+
+    float density(int x, int y, int z) const {
+        if (sampling == Sampling::Exact) return noiseAt(originX + x, y, originZ + z);
+        return dense[(size_t)y + (size_t)ySize * (x + (size_t)width * z)];
+    }
+    bool isCave(int x, int y, int z) const { return density(x, y, z) > THRESHOLD; }
+
+    // Noise evaluations made so far (lattice points, or voxels for Exact).
+    size_t getSampleCount() const { return samples; }
+
+private:
+    float noiseAt(int worldX, int y, int worldZ) const;
+    void fillFromLattice(int latticeXZ, int latticeY);
+
+    int seed;
+    std::unique_ptr<FastNoiseLite> noise; // Runtime only
+    Sampling sampling;
+    int originX, originZ;
+    int width, depth, ySize;
+    std::vector<float> dense; // interpolated field, y fastest, then x, then z
+    mutable size_t samples = 0;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+// Scalar port of FastNoiseLite's 3D OpenSimplex2 for a noise configuration
+// fixed at compile time: GetNoise(x, y, z) with the default OpenSimplex2
+// rotation and no fractal, at Settings::FREQUENCY. FastNoiseLite decides the
+// rotation, noise type and fractal with a switch on every call; here they are
+// resolved by the compiler and the whole evaluation inlines into the caller's
+// loop. Operation order matches FastNoiseLite, so results are bit for bit
+// the same. Internal linkage, like HeightNoiseKernel.h.
+
+#include <cstdint>
+
+namespace {
+
+// FastNoiseLite::Lookup<float>::Gradients3D (private there)
+alignas(64) const float kGradients3D[256] = {
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+    1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+    1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+    1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+    1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+    1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+    1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+    1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+    1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+    1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+    1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+    1.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+};
+
+template <class Settings>
+struct OpenSimplex3Kernel {
+    static constexpr int PRIME_X = 501125321;
+    static constexpr int PRIME_Y = 1136930381;
+    static constexpr int PRIME_Z = 1720413743;
+
+    // 32-bit wrapping multiply, as FastNoiseLite's int arithmetic does in practice
+    static int mulWrap(int a, int b) { return (int)((uint32_t)a * (uint32_t)b); }
+
+    static int fastRound(float f) { return f >= 0 ? (int)(f + 0.5f) : (int)(f - 0.5f); }
+
+    static float gradCoord(int seed, int xPrimed, int yPrimed, int zPrimed, float xd, float yd, float zd) {
+        int hash = mulWrap(seed ^ xPrimed ^ yPrimed ^ zPrimed, 0x27d4eb2d);
+        hash ^= hash >> 15;
+        hash &= 63 << 2;
+        return xd * kGradients3D[hash] + yd * kGradients3D[hash | 1] + zd * kGradients3D[hash | 2];
+    }
+
+    static float noise(int seed, float x, float y, float z) {
+        x *= Settings::FREQUENCY;
+        y *= Settings::FREQUENCY;
+        z *= Settings::FREQUENCY;
+
+        // TransformType3D_DefaultOpenSimplex2
+        const float R3 = (float)(2.0 / 3.0);
+        float r = (x + y + z) * R3; // Rotation, not skew
+        x = r - x;
+        y = r - y;
+        z = r - z;
+
+        // SingleOpenSimplex2: two offset rotated cube grids
+        int i = fastRound(x);
+        int j = fastRound(y);
+        int k = fastRound(z);
+        float x0 = x - i;
+        float y0 = y - j;
+        float z0 = z - k;
+
+        int xNSign = (int)(-1.0f - x0) | 1;
+        int yNSign = (int)(-1.0f - y0) | 1;
+        int zNSign = (int)(-1.0f - z0) | 1;
+
+        float ax0 = xNSign * -x0;
+        float ay0 = yNSign * -y0;
+        float az0 = zNSign * -z0;
+
+        i = mulWrap(i, PRIME_X);
+        j = mulWrap(j, PRIME_Y);
+        k = mulWrap(k, PRIME_Z);
+
+        float value = 0;
+        float a = (0.6f - x0 * x0) - (y0 * y0 + z0 * z0);
+
+        for (int l = 0;; l++) {
+            if (a > 0) value += (a * a) * (a * a) * gradCoord(seed, i, j, k, x0, y0, z0);
+
+            float b = a + 1;
+            int i1 = i;
+            int j1 = j;
+            int k1 = k;
+            float x1 = x0;
+            float y1 = y0;
+            float z1 = z0;
+
+            if (ax0 >= ay0 && ax0 >= az0) {
+                x1 += xNSign;
+                b -= xNSign * 2 * x1;
+                i1 -= xNSign * PRIME_X;
+            } else if (ay0 > ax0 && ay0 >= az0) {
+                y1 += yNSign;
+                b -= yNSign * 2 * y1;
+                j1 -= yNSign * PRIME_Y;
+            } else {
+                z1 += zNSign;
+                b -= zNSign * 2 * z1;
+                k1 -= zNSign * PRIME_Z;
+            }
+
+            if (b > 0) value += (b * b) * (b * b) * gradCoord(seed, i1, j1, k1, x1, y1, z1);
+
+            if (l == 1) break;
+
+            ax0 = 0.5f - ax0;
+            ay0 = 0.5f - ay0;
+            az0 = 0.5f - az0;
+
+            x0 = xNSign * ax0;
+            y0 = yNSign * ay0;
+            z0 = zNSign * az0;
+
+            a += (0.75f - ax0) - (ay0 + az0);
+
+            i += (xNSign >> 1) & PRIME_X;
+            j += (yNSign >> 1) & PRIME_Y;
+            k += (zNSign >> 1) & PRIME_Z;
+
+            xNSign = -xNSign;
+            yNSign = -yNSign;
+            zNSign = -zNSign;
+
+            seed = ~seed;
+        }
+
+        return value * 32.69428253173828125f;
+    }
+};
+
+} // namespace
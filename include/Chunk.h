@@ -1,42 +1,126 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <cstdint>
+#include "Block.h"
+#include "BlockStorage.h"
+#include "ChunkLayout.h"
+#include "CaveField.h"
 
-enum class BlockType : uint8_t {
-    Air = 0,
-    Grass = 1,
-    Stone = 2,
-    Dirt = 3,
-    Ore = 4
+// A vertical slice of a chunk, SECTION_HEIGHT blocks tall.
+// Sections where every voxel holds the same type keep only that value;
+// the storage takes an index buffer on the first write that differs. The
+// storage and its palette live as long as the chunk, so a pooled chunk
+// reuses them on every load instead of allocating new ones.
+struct ChunkSection {
+    BlockType uniform = BlockType::Air;
+    bool dense = false;   // storage holds the voxels, not uniform
+    BlockStorage storage;
+
+    bool isUniform() const { return !dense; }
+    bool isEmpty() const { return !dense && uniform == BlockType::Air; }
+};
+
+// Shape of one ramp voxel. Only a few dozen blocks per chunk are ramps, so
+// they live in a sorted side list instead of a byte on every voxel.
+struct RampEntry {
+    uint8_t x, y, z;
+    RampDirection dir;
 };
 
-enum class RampDirection : uint8_t {
-    None = 0,
-    North = 1,
-    South = 2,
-    East = 3,
-    West = 4,
-    NorthEast = 5,
-    NorthWest = 6,
-    SouthEast = 7,
-    SouthWest = 8
+// One block changed after generation, in chunk coords
+struct BlockEdit {
+    uint8_t x, y, z;
+    Block block;
 };
 
-struct Block {
-    BlockType type = BlockType::Air;
-    RampDirection ramp = RampDirection::None;
+// A chunk's surface before ramps: top y and block type per column, x-major
+// like the heightmap. The ramp stage reads it across chunk borders.
+struct ChunkSurface {
+    std::vector<int16_t> height;
+    std::vector<BlockType> top;
 };
 
 class Chunk {
 public:
+    static constexpr int SECTION_HEIGHT = 16;
+    // Top block of every column before ramps
+    static constexpr BlockType SURFACE_TYPE = BlockType::Grass;
+
     Chunk(int chunkX, int chunkZ, int w, int h, int d);
+    // blockData is the payload produced by serialize()
     Chunk(int chunkX, int chunkZ, int w, int h, int d, const std::vector<uint8_t>& blockData);
 
-    void generateSimpleTerrain();
-    void addRampsToTerrain();
+    // Replace contents with a serialize() payload.
+    void deserialize(const std::vector<uint8_t>& blockData);
+
+    // Reinitialise as an empty chunk at new coords, keeping allocated capacity
+    // and each section's storage. Index buffers go back to the BlockBufferPool.
+    void reset(int chunkX, int chunkZ);
+
+    // Generation stages after the heightmap, run in this order by
+    // ChunkPipeline. Output depends only on worldSeed, the chunk coords and
+    // the neighbours' surfaces, so chunks come out the same in any order.
+    //
+    // Stone, ores and caves up to 3 below each column's surface. Lattice
+    // trades exact caves for far fewer 3D noise evaluations.
+    void carveTerrain(int32_t worldSeed, const int* columnHeight, CaveField::Sampling caves);
+    // Dirt and grass for the top three blocks of each column.
+    void coverSurface(const int* columnHeight);
+    ChunkSurface getSurface() const;
+    // A ramp on every column one below a neighbouring column, which may be in
+    // the next chunk. around[(dx + 1) + 3 * (dz + 1)] is the surface of the
+    // chunk at offset (dx, dz), so around[4] is this chunk's own; a null
+    // neighbour counts as having no columns.
+    void addRamps(const ChunkSurface* const around[9]);
+
+    Block getBlock(int x, int y, int z) const { return Block{getBlockType(x, y, z), getRamp(x, y, z)}; }
+    BlockType getBlockType(int x, int y, int z) const;
+    RampDirection getRamp(int x, int y, int z) const;
+    // Also keeps the heightmap, solid range and ramp overlay current.
+    void setBlock(int x, int y, int z, Block b);
+
+    // Ramp overlay, sorted by (z, y, x).
+    const std::vector<RampEntry>& getRamps() const { return ramps; }
+
+    // Heightmap: y of the highest non-air block in column (x, z), -1 if the column is empty.
+    int getTopHeight(int x, int z) const { return heightmap[x + width * z]; }
+    // Lowest and highest y holding any non-air block, -1 if the chunk is empty.
+    int getMinSolidY() const { return minSolidY; }
+    int getMaxSolidY() const { return maxSolidY; }
+
+    // Column bitmasks for chunks at most 64 tall: bit y set where the block
+    // is non-air, or for getTypeColumns where it is of type t, stored at
+    // out[t * width * depth + x + width * z] for all BLOCK_TYPE_COUNT types.
+    // The solid columns are kept with the heightmap, so reading one is O(1).
+    uint64_t getSolidColumn(int x, int z) const { return solidColumns[x + width * z]; }
+    void getTypeColumns(uint64_t* out) const;
 
-    const std::vector<Block>& getBlocks() const { return blocks; }
+    // Collapse sections whose voxels are all the same back to a uniform tag.
+    void compactSections();
+
+    // Per-section tag followed by either one type or the section's dense types,
+    // then the ramp overlay.
+    std::vector<uint8_t> serialize() const;
+
+    // Edits in wire form; applyEdits replays them with setBlock. False if
+    // the payload is malformed or out of bounds, having applied none.
+    static std::vector<uint8_t> serializeEdits(const std::vector<BlockEdit>& edits);
+    bool applyEdits(const std::vector<uint8_t>& payload);
+
+    int getSectionCount() const { return (int)sections.size(); }
+    const ChunkSection& getSection(int s) const { return sections[s]; }
+
+    // Visit every voxel of section s in SectionLayout storage order as f(x, y, z, type).
+    template <class F> void forEachInSection(int s, F&& f) const {
+        const ChunkSection& sec = sections[s];
+        const int yBase = s * SECTION_HEIGHT;
+        SectionLayout::forEach(width, SECTION_HEIGHT, depth, [&](int x, int ly, int z, size_t i) {
+            if (yBase + ly >= height) return;
+            f(x, yBase + ly, z, sec.dense ? sec.storage.get(i) : sec.uniform);
+        });
+    }
 
     int getChunkX() const { return cx; }
     int getChunkZ() const { return cz; }
@@ -44,10 +128,33 @@ public:
     int getHeight() const { return height; }
     int getDepth() const { return depth; }
 
+    size_t getMemoryUsage() const;
+
 private:
     int cx, cz;
     int width, height, depth;
-    std::vector<Block> blocks;
+    std::vector<ChunkSection> sections;
+    std::vector<RampEntry> ramps;
 
-    int index(int x, int y, int z) const { return x + width * (y + height * z); }
+    std::vector<int16_t> heightmap;         // width * depth, x-major
+    std::vector<uint64_t> solidColumns;     // width * depth, bit y for non-air y < 64
+    std::vector<uint16_t> layerSolidCount;  // non-air blocks per y layer
+    int minSolidY = -1;
+    int maxSolidY = -1;
+
+    void setRamp(int x, int y, int z, RampDirection dir);
+
+    void updateHeightmap(int x, int y, int z, bool solid);
+    void rebuildHeightmap();
+    void recomputeSolidRange();
+
+    size_t sectionVolume() const { return SectionLayout::volume(width, SECTION_HEIGHT, depth); }
+    // index within a section, ly in [0, SECTION_HEIGHT)
+    int sectionIndex(int x, int ly, int z) const {
+        return (int)SectionLayout::index(x, ly, z, width, SECTION_HEIGHT, depth);
+    }
 };
+
+// Shared, immutable view of a published chunk version. Holders may read it
+// without any lock; edits publish a new version instead of mutating this one.
+using ChunkRef = std::shared_ptr<const Chunk>;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ChunkManager.h"
+#include "ChunkMap.h"
+
+// Resolves to the generated chunk, or nullptr if the pool stopped first.
+// Poll with wait_for(0) to avoid blocking; copies are cheap.
+using ChunkHandle = std::shared_future<ChunkRef>;
+
+// Worker threads that generate chunks into a ChunkManager. Requests are
+// served nearest-player first; a request for a chunk that is already queued
+// or generating shares the existing handle.
+//
+// Workers with no request to serve pregenerate: they work down a list of
+// chunks players are likely to need soon (see PregenPlanner), so those
+// requests find the chunk already loaded.
+class ChunkGenPool {
+public:
+    static constexpr size_t PREGEN_MEMORY_CAP = 32u << 20;
+
+    struct PregenStats {
+        uint64_t generated = 0; // chunks pregenerated
+        uint64_t hits = 0;      // requests that found a pregenerated chunk ready
+        uint64_t early = 0;     // requests for a chunk whose pregeneration had started
+        uint64_t evicted = 0;   // unloaded unclaimed to stay under the memory cap
+        size_t unclaimedBytes = 0; // memory of pregenerated chunks nobody asked for yet
+    };
+
+    // threads == 0 uses one per hardware thread
+    explicit ChunkGenPool(ChunkManager& manager, unsigned threads = 0);
+    ~ChunkGenPool();
+
+    ChunkHandle request(int chunkX, int chunkZ);
+
+    // Chunk coords of every player; queued requests are reordered by their
+    // distance to the nearest one.
+    void setPlayerChunks(const std::vector<ChunkKey>& players);
+
+    // Chunks to pregenerate in order, replacing the previous list.
+    // Pregeneration yields to requests: a worker only starts a pregen chunk
+    // when no request is queued, and one worker is always kept free for
+    // requests, so a pool of one never pregenerates. It pauses while
+    // unclaimed pregenerated chunks take up the memory cap, and those
+    // furthest from every player are unloaded to get back under it.
+    void setPregenTargets(std::vector<ChunkKey> targets);
+    void setPregenMemoryCap(size_t bytes);
+    PregenStats getPregenStats() const;
+
+    // Finish the chunk being generated on each worker, then fail the rest.
+    void stop();
+
+    size_t getQueuedCount() const;
+    unsigned getThreadCount() const { return (unsigned)workers.size(); }
+
+private:
+    struct Job {
+        ChunkKey key;
+        long priority; // squared distance to the nearest player, smaller first
+        uint64_t seq;  // FIFO among equals
+        std::shared_ptr<std::promise<ChunkRef>> promise;
+    };
+    struct JobLater {
+        bool operator()(const Job& a, const Job& b) const {
+            return a.priority != b.priority ? a.priority > b.priority : a.seq > b.seq;
+        }
+    };
+
+    void workerMain();
+    long priorityOf(const ChunkKey& key) const;
+    // Next pregen target worth generating, if pregeneration may run now.
+    bool nextPregen(ChunkKey& key);
+    void pregenerate(const ChunkKey& key);
+    // Unloads unclaimed pregenerated chunks, furthest first, until they fit
+    // the cap. Called with mtx held.
+    void evictPregenerated();
+
+    ChunkManager& manager;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex mtx; // guards everything below
+    std::condition_variable wake;
+    std::vector<Job> queue; // heap ordered by JobLater
+    ChunkMap<ChunkHandle> inFlight;
+    std::vector<ChunkKey> players;
+    uint64_t nextSeq = 0;
+    bool stopping = false;
+
+    std::vector<ChunkKey> pregenTargets;
+    size_t pregenNext = 0;          // first target not yet considered
+    unsigned pregenRunning = 0;
+    unsigned pregenWorkers;         // most workers pregenerating at once
+    size_t pregenCap = PREGEN_MEMORY_CAP;
+    ChunkMap<bool> pregenActive;    // being pregenerated; true once requested
+    ChunkMap<size_t> pregenerated;  // unclaimed, with their memory use
+    PregenStats pregenStats;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Voxel orderings for one chunk section (w x h x d, h = Chunk::SECTION_HEIGHT).
+// Each layout maps (x, y, z) to a storage index, and forEach visits voxels in
+// storage order so loops walk memory sequentially.
+
+// x fastest, then y, then z (the original ordering)
+struct LinearLayout {
+    static constexpr const char* name = "linear";
+    static constexpr uint8_t id = 0;
+
+    static size_t volume(int w, int h, int d) { return (size_t)w * h * d; }
+    static size_t index(int x, int y, int z, int w, int h, int /*d*/) {
+        return (size_t)x + (size_t)w * (y + (size_t)h * z);
+    }
+    template <class F> static void forEach(int w, int h, int d, F&& f) {
+        size_t i = 0;
+        for (int z = 0; z < d; ++z)
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x) f(x, y, z, i++);
+    }
+};
+
+// y fastest: each column is contiguous, matching column-wise generation and meshing
+struct ColumnLayout {
+    static constexpr const char* name = "column";
+    static constexpr uint8_t id = 1;
+
+    static size_t volume(int w, int h, int d) { return (size_t)w * h * d; }
+    static size_t index(int x, int y, int z, int w, int h, int /*d*/) {
+        return (size_t)y + (size_t)h * (x + (size_t)w * z);
+    }
+    template <class F> static void forEach(int w, int h, int d, F&& f) {
+        size_t i = 0;
+        for (int z = 0; z < d; ++z)
+            for (int x = 0; x < w; ++x)
+                for (int y = 0; y < h; ++y) f(x, y, z, i++);
+    }
+};
+
+// Z-order curve: bits of x, y and z interleaved, so all six neighbours of a
+// voxel are usually within the same cache line or the next one. The section is
+// padded up to a power-of-two cube.
+struct MortonLayout {
+    static constexpr const char* name = "morton";
+    static constexpr uint8_t id = 2;
+
+    static uint32_t spread(uint32_t v) {
+        // 10-bit value -> bits 0, 3, 6, ...
+        v &= 0x3FF;
+        v = (v | (v << 16)) & 0x030000FF;
+        v = (v | (v << 8)) & 0x0300F00F;
+        v = (v | (v << 4)) & 0x030C30C3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+    static uint32_t compact(uint32_t v) {
+        v &= 0x09249249;
+        v = (v | (v >> 2)) & 0x030C30C3;
+        v = (v | (v >> 4)) & 0x0300F00F;
+        v = (v | (v >> 8)) & 0x030000FF;
+        v = (v | (v >> 16)) & 0x3FF;
+        return v;
+    }
+    static int bitsFor(int w, int h, int d) {
+        int m = w > h ? w : h;
+        if (d > m) m = d;
+        int b = 0;
+        while ((1 << b) < m) ++b;
+        return b;
+    }
+
+    static size_t volume(int w, int h, int d) { return (size_t)1 << (3 * bitsFor(w, h, d)); }
+    static size_t index(int x, int y, int z, int, int, int) {
+        return spread((uint32_t)x) | (spread((uint32_t)y) << 1) | (spread((uint32_t)z) << 2);
+    }
+    template <class F> static void forEach(int w, int h, int d, F&& f) {
+        size_t n = volume(w, h, d);
+        for (size_t i = 0; i < n; ++i) {
+            int x = (int)compact((uint32_t)i);
+            int y = (int)compact((uint32_t)i >> 1);
+            int z = (int)compact((uint32_t)i >> 2);
+            if (x < w && y < h && z < d) f(x, y, z, i);
+        }
+    }
+};
+
+// Chosen at build time: make CHUNK_LAYOUT=LINEAR|COLUMN|MORTON (needs a clean rebuild).
+#if defined(CHUNK_LAYOUT_LINEAR)
+using SectionLayout = LinearLayout;
+#elif defined(CHUNK_LAYOUT_MORTON)
+using SectionLayout = MortonLayout;
+#else
+using SectionLayout = ColumnLayout;
+#endif
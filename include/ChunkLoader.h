@@ -1,17 +1,16 @@
 
 #pragma once
 
-#include "ChunkManager.h" // for ChunkKey (your ChunkKey type)
+#include "ChunkWindow.h"
 #include "Client.h"
 #include "Player.h"
 #include "ChunkMeshBuilder.h"
 
 #include <vector>
-#include <unordered_map>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <mutex>
-#include <set>
 
 class ChunkLoader {
 public:
@@ -22,8 +21,9 @@ public:
     void start();
     void stop();
 
-    // Return a combined mesh (copy) of all loaded chunks. Thread-safe.
-    std::vector<Vertex> getCombinedMesh();
+    // Return the mesh (copy) of every loaded chunk, in chunk-local positions;
+    // draw each at its chunk's origin (index * chunkSize). Thread-safe.
+    std::vector<std::pair<ChunkKey, ChunkMesh>> getMeshes();
 
     // Optional: check if loader has any chunks loaded yet
     bool hasChunks() const;
@@ -31,6 +31,8 @@ public:
 private:
     void threadMain(); // background worker
     void requestAndStoreChunk(int chunkX, int chunkZ);
+    // (Re)build a stored chunk's mesh against its loaded neighbours
+    void remeshChunk(int chunkX, int chunkZ);
 
     Client* client;    // pointer owned externally (client must outlive loader)
     Player* player;    // pointer owned externally
@@ -40,9 +42,16 @@ private:
     std::thread worker;
     std::atomic<bool> running;
 
-    // loaded meshes keyed by chunk index
-    std::unordered_map<ChunkKey, std::vector<Vertex>> loadedChunks;
-    std::set<std::pair<int,int>> pendingRequests;
+    // a claimed cell is either waiting on the server or holds the chunk and
+    // its mesh; the blocks stay so neighbours can be meshed against them
+    struct LoadedChunk {
+        bool pending = false;
+        std::shared_ptr<const Chunk> chunk;
+        ChunkMesh mesh;
+    };
 
-    mutable std::mutex mtx; // protects loadedChunks & pendingRequests
+    // chunks around the player, recentred each sweep
+    ChunkWindow<LoadedChunk> loadedChunks;
+
+    mutable std::mutex mtx; // protects loadedChunks
 };
@@ -1,46 +1,114 @@
 #pragma once
 #include "Chunk.h"
-#include <unordered_map>
+#include "ChunkPool.h"
+#include "ChunkPipeline.h"
+#include "ChunkMap.h"
+#include "WorldStorage.h"
 #include <memory>
 #include <vector>
 #include <glm/vec2.hpp>
 #include <mutex>
-
-struct ChunkKey {
-    int x, z;
-    bool operator==(const ChunkKey& o) const { return x==o.x && z==o.z; }
-};
-namespace std {
-  template<> struct hash<ChunkKey> {
-    size_t operator()(ChunkKey const& k) const noexcept {
-      return (std::hash<int>()(k.x) * 73856093) ^ (std::hash<int>()(k.z) * 19349663);
-    }
-  };
-}
+#include <condition_variable>
+#include <array>
+#include <atomic>
+#include <unordered_map>
 
 class ChunkManager {
 public:
-    ChunkManager(int chunkSize = 16, int renderDistance = 4);
+    static constexpr int CHUNK_HEIGHT = 64;
+
+    // hugePages backs pooled block buffers with 2 MB pages where the OS allows it
+    ChunkManager(int chunkSize = 16, int renderDistance = 4, bool hugePages = false);
 
-    // Server-side: load (generate) chunk
+    // Server-side: load (generate) chunk. Generation runs outside every lock;
+    // a concurrent call for the same chunk waits for it instead of generating twice.
+    // Neighbours are generated up to their surface for cross-border ramps and
+    // kept for when they are loaded themselves, as long as a loaded chunk
+    // borders them. Chunks in the storage, if
+    // one is set, are read from it instead.
     void loadChunk(int chunkX, int chunkZ);
-    Chunk* getChunk(int chunkX, int chunkZ); // pointer or nullptr
+    // Complete chunks for loadChunk to read rather than generate, e.g. written
+    // by tools/Pregen; it must have been opened for this world's seed and cave
+    // sampling and hold chunks exactly as generated. Set it before the first
+    // load and any setCaveSampling.
+    void setStorage(std::shared_ptr<WorldStorage> s) { storage = std::move(s); }
+    // How loadChunk samples caves; see CaveField. Exact by default.
+    void setCaveSampling(CaveField::Sampling s) { caveSampling = s; }
+    CaveField::Sampling getCaveSampling() const { return caveSampling; }
+    // Seed for every chunk loadChunk generates from now on; 0 by default.
+    // Set it before the first load: partly generated neighbours keep theirs.
+    void setWorldSeed(int32_t seed) { worldSeed = seed; }
+    int32_t getWorldSeed() const { return worldSeed; }
+    // Coarse terrain for areas only seen from afar: the pre-ramp surface of
+    // the chunks x chunks block of chunks starting at (chunkX, chunkZ), as
+    // chunks * chunkSize columns a side, x-major. Only the height noise is
+    // evaluated and nothing is stored, so it is a small fraction of the cost
+    // of loadChunk and works at any distance. Caves never reach the surface,
+    // so generated chunks match it except where a ramp sits on top.
+    ChunkSurface generateSurface(int chunkX, int chunkZ, int chunks = 1) const;
+    // Current version of a chunk, or nullptr (also while it is still being
+    // generated; never blocks on generation). The returned ref stays valid
+    // after unloadChunk or setBlock; it just stops being the latest version.
+    ChunkRef getChunk(int chunkX, int chunkZ);
+
+    // Edit one block in world coords. Copy-on-write: readers holding the old
+    // version keep seeing it. The copy is made outside the shard lock; if
+    // another edit lands first, it is redone on the newer version. Returns
+    // false if the chunk isn't loaded.
+    bool setBlock(int worldX, int y, int worldZ, Block b);
+    // Current version of a chunk (nullptr as getChunk) and every block
+    // setBlock changed in it since it was loaded, latest per position.
+    // Replaying the edits on a freshly generated chunk gives this version.
+    ChunkRef getChunkWithEdits(int chunkX, int chunkZ, std::vector<BlockEdit>& edits);
 
     // Client-side: accept chunk bytes from server
     void loadChunkFromData(int chunkX, int chunkZ, int w, int h, int d, const std::vector<uint8_t>& blocks);
 
-    // Build one combined vertex array for all currently loaded chunks (client uses this to send to renderer)
-    // The build of vertex positions/UVs is done by client's existing buildChunkMesh helper (we just gather bytes)
-    std::vector<std::pair<ChunkKey, std::shared_ptr<Chunk>>> getLoadedChunksSnapshot();
+    // Refs to every loaded chunk at the time of the call; safe to read
+    // without the manager lock while chunks are edited or unloaded.
+    std::vector<std::pair<ChunkKey, ChunkRef>> getLoadedChunksSnapshot();
 
     int getChunkSize() const { return chunkSize; }
     int getRenderDistance() const { return renderDistance; }
 std::vector<uint8_t> serializeChunk(int chunkX, int chunkZ);
 void unloadChunk(int chunkX, int chunkZ); 
 size_t getLoadedChunkCount();
+
+    PoolStats getChunkPoolStats() const { return chunkPool->getStats(); }
+    PoolStats getBufferPoolStats() const { return BlockBufferPool::instance().getStats(); }
+    size_t getPartialChunkCount() const { return pipeline.getPartialCount(); }
+    ChunkPipeline::StageTimes getStageTimes() const { return pipeline.getStageTimes(); }
 private:
-    std::unordered_map<ChunkKey, std::unique_ptr<Chunk>> chunks;
+    // A chunk being generated has a slot with a null chunk and generating set.
+    struct Slot {
+        ChunkRef chunk;
+        bool generating = false;
+        std::vector<BlockEdit> edits; // since loadChunk, one per position
+        std::unordered_map<uint32_t, uint32_t> editIndex; // x | y << 8 | z << 16 -> index in edits
+    };
+
+    // The table is split into independently locked shards so lookups on one
+    // chunk never queue behind work on another. Locks guard map access only.
+    struct Shard {
+        std::mutex mtx;
+        std::condition_variable generated;
+        ChunkMap<Slot> chunks;
+    };
+    static constexpr size_t SHARD_COUNT = 16;
+
+    Shard& shardFor(const ChunkKey& key) { return shards[chunkKeyMix(chunkKeyCode(key)) % SHARD_COUNT]; }
+
+    std::array<Shard, SHARD_COUNT> shards;
+    std::shared_ptr<ChunkPool> chunkPool;
     int chunkSize;
     int renderDistance;
-    std::mutex mtx;
+    ChunkPipeline pipeline;
+    std::atomic<CaveField::Sampling> caveSampling{CaveField::Sampling::Exact};
+    std::atomic<int32_t> worldSeed{0};
+    std::shared_ptr<WorldStorage> storage;
+
+    // The chunk as stored, or nullptr if there is no storage or it lacks the chunk
+    std::unique_ptr<Chunk> loadStored(int chunkX, int chunkZ);
+
+    int floorDiv(int v) const { return v >= 0 ? v / chunkSize : (v + 1) / chunkSize - 1; }
 };
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct ChunkKey {
+    int x, z;
+    bool operator==(const ChunkKey& o) const { return x==o.x && z==o.z; }
+};
+
+// 64-bit key with the bits of x and z interleaved (x in even bits, z in odd),
+// so chunks that are close in the world are close in key space.
+inline uint64_t chunkKeyCode(const ChunkKey& k) {
+    auto spread = [](uint32_t v) {
+        uint64_t r = v;
+        r = (r | (r << 16)) & 0x0000FFFF0000FFFFull;
+        r = (r | (r << 8)) & 0x00FF00FF00FF00FFull;
+        r = (r | (r << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        r = (r | (r << 2)) & 0x3333333333333333ull;
+        r = (r | (r << 1)) & 0x5555555555555555ull;
+        return r;
+    };
+    return spread((uint32_t)k.x) | (spread((uint32_t)k.z) << 1);
+}
+
+// Fibonacci hashing: the high bits of the product depend on every key bit.
+inline uint64_t chunkKeyMix(uint64_t code) { return code * 0x9E3779B97F4A7C15ull; }
+
+// Open-addressing hash map from ChunkKey to V with linear probing. Entries live
+// in one flat array, so a lookup is usually a single cache line instead of a
+// node chase. Capacity is a power of two and kept at most 3/4 full; erase
+// shifts the following run back instead of leaving tombstones.
+//
+// Pointers and iterators are invalidated by any insert or erase.
+template <class V>
+class ChunkMap {
+public:
+    using value_type = std::pair<ChunkKey, V>;
+
+    ChunkMap() = default;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return slots.size(); }
+
+    void clear() {
+        slots.clear();
+        count = 0;
+        shift = 64;
+    }
+
+    void reserve(size_t n) {
+        size_t cap = 16;
+        while (cap * 3 / 4 < n) cap *= 2;
+        if (cap > slots.size()) rehash(cap);
+    }
+
+    V* find(const ChunkKey& key) {
+        if (count == 0) return nullptr;
+        uint64_t code = chunkKeyCode(key);
+        for (size_t i = home(code);; i = next(i)) {
+            Slot& s = slots[i];
+            if (!s.used) return nullptr;
+            if (s.code == code) return &s.kv.second;
+        }
+    }
+    const V* find(const ChunkKey& key) const { return const_cast<ChunkMap*>(this)->find(key); }
+    bool contains(const ChunkKey& key) const { return find(key) != nullptr; }
+
+    // Inserts key -> value unless key is present. Returns the stored value and
+    // whether it was inserted.
+    std::pair<V*, bool> emplace(const ChunkKey& key, V value) {
+        if ((count + 1) * 4 > slots.size() * 3) rehash(slots.empty() ? 16 : slots.size() * 2);
+        uint64_t code = chunkKeyCode(key);
+        size_t i = home(code);
+        for (; slots[i].used; i = next(i))
+            if (slots[i].code == code) return {&slots[i].kv.second, false};
+        Slot& s = slots[i];
+        s.used = true;
+        s.code = code;
+        s.kv.first = key;
+        s.kv.second = std::move(value);
+        ++count;
+        return {&s.kv.second, true};
+    }
+
+    V& operator[](const ChunkKey& key) { return *emplace(key, V()).first; }
+
+    bool erase(const ChunkKey& key) {
+        if (count == 0) return false;
+        uint64_t code = chunkKeyCode(key);
+        size_t i = home(code);
+        for (;; i = next(i)) {
+            if (!slots[i].used) return false;
+            if (slots[i].code == code) break;
+        }
+        // backward-shift: pull later entries of the probe run into the hole
+        // when the hole lies between their home slot and where they sit
+        size_t hole = i;
+        for (size_t j = next(i); slots[j].used; j = next(j)) {
+            size_t h = home(slots[j].code);
+            if (((j - h) & mask()) >= ((j - hole) & mask())) {
+                slots[hole].code = slots[j].code;
+                slots[hole].kv = std::move(slots[j].kv);
+                hole = j;
+            }
+        }
+        slots[hole].used = false;
+        slots[hole].kv.second = V();
+        --count;
+        return true;
+    }
+
+    template <bool Const>
+    class Iter {
+    public:
+        using Ref = typename std::conditional<Const, const value_type&, value_type&>::type;
+        using Ptr = typename std::conditional<Const, const value_type*, value_type*>::type;
+        using Base = typename std::conditional<Const, const ChunkMap*, ChunkMap*>::type;
+
+        Iter(Base m, size_t i) : map(m), idx(i) { skip(); }
+        Ref operator*() const { return map->slots[idx].kv; }
+        Ptr operator->() const { return &map->slots[idx].kv; }
+        Iter& operator++() { ++idx; skip(); return *this; }
+        bool operator!=(const Iter& o) const { return idx != o.idx; }
+        bool operator==(const Iter& o) const { return idx == o.idx; }
+    private:
+        void skip() { while (idx < map->slots.size() && !map->slots[idx].used) ++idx; }
+        Base map;
+        size_t idx;
+    };
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+private:
+    struct Slot {
+        uint64_t code = 0;
+        bool used = false;
+        value_type kv{};
+    };
+
+    size_t mask() const { return slots.size() - 1; }
+    size_t home(uint64_t code) const { return (size_t)(chunkKeyMix(code) >> shift); }
+    size_t next(size_t i) const { return (i + 1) & mask(); }
+
+    void rehash(size_t cap) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(cap);
+        shift = 64;
+        while (((size_t)1 << (64 - shift)) < cap) --shift;
+        for (Slot& s : old) {
+            if (!s.used) continue;
+            size_t i = home(s.code);
+            while (slots[i].used) i = next(i);
+            slots[i] = std::move(s);
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+    int shift = 64;
+};
@@ -4,20 +4,46 @@
 #include "Renderer.h"
 #include "Chunk.h"
 
-void addVerticesForRampNorth(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-void addVerticesForRampSouth(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-void addVerticesForRampEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-void addVerticesForRampWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-
-
-std::vector<Vertex> buildChunkMesh(const unsigned char* blocks, int width, int height, int depth);
-
-
-void addCubeMesh(BlockType type, glm::vec3 pos, std::vector<Vertex>& verts);
-void addRampMesh(RampDirection dir, BlockType type, glm::vec3 pos, std::vector<Vertex>& verts);
-
-
-void addVerticesForRampNorthEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-void addVerticesForRampNorthWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-void addVerticesForRampSouthEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
-void addVerticesForRampSouthWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts);
+void addVerticesForRampNorth(glm::vec3 pos, int tile, ChunkMesh& mesh);
+void addVerticesForRampSouth(glm::vec3 pos, int tile, ChunkMesh& mesh);
+void addVerticesForRampEast(glm::vec3 pos, int tile, ChunkMesh& mesh);
+void addVerticesForRampWest(glm::vec3 pos, int tile, ChunkMesh& mesh);
+
+
+// The loaded chunks sharing a side with the one being meshed; null where a
+// neighbour isn't loaded.
+struct ChunkNeighbours {
+    const Chunk* negX = nullptr;
+    const Chunk* posX = nullptr;
+    const Chunk* negZ = nullptr;
+    const Chunk* posZ = nullptr;
+};
+
+// How the visible cube faces are found and become quads. All give the same
+// surface; ramps are emitted block by block in every mode.
+enum class MeshMode : uint8_t {
+    PerBlock, // one quad per visible face
+    Greedy,   // adjacent coplanar faces of the same type merged into rectangles:
+              // about half the vertices, but slower to build than PerBlock
+    Bitmask   // PerBlock's quads, found a 64-tall column at a time with bit
+              // operations; taller chunks fall back to PerBlock
+};
+
+// Faces hidden by the voxel next to them are skipped: solid cubes hide the
+// whole face, ramps only with their full sides. Faces on the chunk's edge
+// are tested against the neighbours given and kept where there is none, so
+// remesh a chunk when a neighbour arrives.
+ChunkMesh buildChunkMesh(const Chunk& chunk, const ChunkNeighbours& neighbours = {},
+                         MeshMode mode = MeshMode::Bitmask);
+
+
+// pos is chunk-local, on whole blocks for cubes.
+// faces: bit f set emits face f of the cube (-z, +z, -x, +x, -y, +y)
+void addCubeMesh(BlockType type, glm::vec3 pos, ChunkMesh& mesh, uint8_t faces = 0x3F);
+void addRampMesh(RampDirection dir, BlockType type, glm::vec3 pos, ChunkMesh& mesh);
+
+
+void addVerticesForRampNorthEast(glm::vec3 pos, int tile, ChunkMesh& mesh);
+void addVerticesForRampNorthWest(glm::vec3 pos, int tile, ChunkMesh& mesh);
+void addVerticesForRampSouthEast(glm::vec3 pos, int tile, ChunkMesh& mesh);
+void addVerticesForRampSouthWest(glm::vec3 pos, int tile, ChunkMesh& mesh);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "Chunk.h"
+#include "ChunkMap.h"
+#include "ChunkPool.h"
+
+// Terrain generation stages, in order. A stage runs on a chunk once the chunk
+// and every chunk within the stage's neighbour radius have finished the one
+// before it.
+enum class GenStage : uint8_t {
+    Empty,     // nothing generated yet
+    Heightmap, // surface y per column
+    Carve,     // stone, ores and caves
+    Surface,   // dirt and grass; neighbours' ramps read the result
+    Ramps,     // ramps, including ones across chunk borders; complete
+};
+
+// Chebyshev radius of chunks a stage reads
+constexpr int genStageRadius(GenStage stage) { return stage == GenStage::Ramps ? 1 : 0; }
+
+constexpr int GEN_STAGE_COUNT = (int)GenStage::Ramps + 1;
+
+// Bump whenever the same seed would generate different blocks, so chunks
+// stored by an older generator aren't mixed with new ones (see WorldStorage).
+// tools/GoldenHash catches such changes.
+constexpr uint32_t GENERATOR_VERSION = 1;
+
+// Runs the generation stages as a dependency graph over chunks. Asking for a
+// chunk runs whatever stages it and its neighbours still need; neighbours
+// advanced along the way are kept at the stage they reached and resumed,
+// not regenerated, when they are asked for themselves. They are kept only
+// while a chunk next to them is handed out or being asked for, so what is
+// held follows the loaded area instead of growing behind it.
+//
+// Any number of threads may call generate() at once. They share the partial
+// chunks, run stages outside the lock, and only wait when every stage they
+// still need is already running on another thread.
+class ChunkPipeline {
+public:
+    // Time spent in each stage, indexed by GenStage, summed over every
+    // thread that ran it
+    struct StageTimes {
+        uint64_t runs[GEN_STAGE_COUNT] = {};
+        uint64_t nanos[GEN_STAGE_COUNT] = {};
+    };
+
+    ChunkPipeline(std::shared_ptr<ChunkPool> pool, int chunkSize, int chunkHeight);
+    ~ChunkPipeline();
+
+    // The complete chunk. Only one thread may ask for a given chunk at a time.
+    std::unique_ptr<Chunk> generate(int chunkX, int chunkZ, int32_t worldSeed, CaveField::Sampling caves);
+
+    // The chunk generate() handed out was unloaded. Drops what is kept for it
+    // and its neighbours unless another handed-out or requested chunk still
+    // borders them; ramps regenerate a dropped surface if needed again.
+    void forget(int chunkX, int chunkZ);
+
+    // Chunks held between stages, plus completed ones kept for their surface
+    size_t getPartialCount() const;
+    StageTimes getStageTimes() const;
+
+private:
+    struct Proto {
+        GenStage stage = GenStage::Empty;
+        bool busy = false;                            // a stage is running on it
+        bool requested = false;                       // a generate() for it is running
+        bool handedOut = false;                       // generated and not forgotten since
+        std::unique_ptr<Chunk> chunk;                 // handed out once complete
+        std::vector<int> columnHeight;                // Heightmap until Surface
+        std::shared_ptr<const ChunkSurface> surface;  // from Surface on
+    };
+    struct Task {
+        ChunkKey key;
+        GenStage stage;
+    };
+    enum class Next { Done, Run, Blocked };
+
+    // Find a stage that can run now towards key reaching want.
+    Next next(const ChunkKey& key, GenStage want, Task& out);
+    // Runs task with lk released; lk is held again on return.
+    void run(std::unique_lock<std::mutex>& lk, const Task& task, int32_t worldSeed, CaveField::Sampling caves);
+    // Releases key's proto unless it or a chunk next to it is handed out or
+    // requested, or a stage is running on it. Called with mtx held.
+    void dropIfUnneeded(const ChunkKey& key);
+
+    std::shared_ptr<ChunkPool> pool;
+    int chunkSize;
+    int chunkHeight;
+
+    mutable std::mutex mtx; // guards protos and times
+    std::condition_variable advanced;
+    ChunkMap<Proto> protos;
+    StageTimes times;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Chunk.h"
+#include "BlockBufferPool.h"
+
+// Recycles Chunk objects (and their heightmap / section arrays) across
+// unload and load, so a walking player doesn't churn the allocator.
+// Block index buffers are recycled separately by BlockBufferPool.
+// Must be owned by a shared_ptr: published chunks keep their pool alive.
+class ChunkPool : public std::enable_shared_from_this<ChunkPool> {
+public:
+    explicit ChunkPool(size_t maxFree = 256);
+
+    std::unique_ptr<Chunk> acquire(int chunkX, int chunkZ, int w, int h, int d);
+    void release(std::unique_ptr<Chunk> chunk);
+
+    // Freeze a chunk into a refcounted version that returns to this pool
+    // when its last reader lets go.
+    ChunkRef publish(std::unique_ptr<Chunk> chunk);
+
+    PoolStats getStats() const;
+
+private:
+    mutable std::mutex mtx;
+    std::vector<std::unique_ptr<Chunk>> freeChunks;
+    size_t maxFree;
+    PoolStats stats;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include "ChunkMap.h"
+
+// Counter-based random numbers for world generation. A value is a pure hash
+// of (world seed, chunk, stream, counter) with no state carried between
+// calls, so a chunk comes out the same whichever thread generates it and
+// whatever was generated before. Give each feature its own stream so adding
+// one never shifts the values another sees.
+class ChunkRandom {
+public:
+    enum Stream : uint32_t {
+        Ores = 1,
+    };
+
+    ChunkRandom(int32_t worldSeed, int chunkX, int chunkZ, Stream stream)
+        : key(mix(mix((uint64_t)(uint32_t)worldSeed | (uint64_t)stream << 32) ^
+                  chunkKeyCode(ChunkKey{chunkX, chunkZ}))) {}
+
+    // 64 random bits for this counter, typically a voxel index
+    uint64_t at(uint64_t counter) const { return mix(key + counter * 0x9E3779B97F4A7C15ull); }
+
+    // Uniform in [0, n), by multiply-shift rather than modulo
+    uint32_t below(uint64_t counter, uint32_t n) const {
+        return (uint32_t)(((at(counter) >> 32) * n) >> 32);
+    }
+
+private:
+    // splitmix64 finaliser
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t key;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ChunkMap.h" // ChunkKey
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Fixed (2R+1)x(2R+1) square of per-chunk values centred on the player's chunk.
+// Cells are indexed by chunk coordinate modulo the side length, so the array
+// never moves: recentring only evicts the cells whose chunk fell outside the
+// square, and the cells they free are exactly the ones the new edge maps to.
+// Lookups, including neighbours of a chunk, are a mod and an index.
+template <class T>
+class ChunkWindow {
+public:
+    explicit ChunkWindow(int radius)
+        : radius(radius), side(2 * radius + 1), cells((size_t)side * side) {}
+
+    int getRadius() const { return radius; }
+    ChunkKey getCenter() const { return center; }
+
+    bool inWindow(int cx, int cz) const {
+        return cx >= center.x - radius && cx <= center.x + radius &&
+               cz >= center.z - radius && cz <= center.z + radius;
+    }
+
+    // Moves the window to (cx, cz). Every occupied cell whose chunk is now
+    // outside is cleared and its key and value appended to evicted (if given).
+    void recenter(int cx, int cz, std::vector<std::pair<ChunkKey, T>>* evicted = nullptr) {
+        if (cx == center.x && cz == center.z) return;
+        center = ChunkKey{cx, cz};
+        for (Cell& c : cells) {
+            if (!c.used || inWindow(c.key.x, c.key.z)) continue;
+            if (evicted) evicted->emplace_back(c.key, std::move(c.value));
+            c = Cell();
+        }
+    }
+
+    // Value for chunk (cx, cz), or nullptr if it is outside the window or has
+    // not been claimed.
+    T* get(int cx, int cz) {
+        if (!inWindow(cx, cz)) return nullptr;
+        Cell& c = cell(cx, cz);
+        return c.used ? &c.value : nullptr;
+    }
+    const T* get(int cx, int cz) const { return const_cast<ChunkWindow*>(this)->get(cx, cz); }
+    bool contains(int cx, int cz) const { return get(cx, cz) != nullptr; }
+
+    // Takes the cell for (cx, cz) and returns its value, default-constructed
+    // if the cell was free. Returns nullptr if (cx, cz) is outside the window.
+    T* claim(int cx, int cz) {
+        if (!inWindow(cx, cz)) return nullptr;
+        Cell& c = cell(cx, cz);
+        if (!c.used) {
+            c.used = true;
+            c.key = ChunkKey{cx, cz};
+        }
+        return &c.value;
+    }
+
+    // Frees the cell for (cx, cz) if it is in the window.
+    void release(int cx, int cz) {
+        if (inWindow(cx, cz)) cell(cx, cz) = Cell();
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const Cell& c : cells) n += c.used;
+        return n;
+    }
+
+    // f(const ChunkKey&, T&) for every claimed cell, in storage order
+    template <class F> void forEach(F&& f) {
+        for (Cell& c : cells)
+            if (c.used) f(c.key, c.value);
+    }
+    template <class F> void forEach(F&& f) const {
+        for (const Cell& c : cells)
+            if (c.used) f(c.key, c.value);
+    }
+
+private:
+    struct Cell {
+        ChunkKey key{0, 0};
+        bool used = false;
+        T value{};
+    };
+
+    int wrap(int v) const {
+        int m = v % side;
+        return m < 0 ? m + side : m;
+    }
+    Cell& cell(int cx, int cz) { return cells[(size_t)wrap(cz) * side + wrap(cx)]; }
+
+    int radius;
+    int side;
+    ChunkKey center{0, 0};
+    std::vector<Cell> cells;
+};
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include "ChunkManager.h"
 #include "Constants.h"
 using socket_t = int;
@@ -10,7 +11,7 @@ using socket_t = int;
 struct ChunkData {
     uint32_t chunkX, chunkY, chunkZ;
     uint16_t width, height, depth;
-    std::vector<uint8_t> blocks;
+    ChunkRef chunk; // null when the request failed
 };
 
 class Client {
@@ -18,11 +19,24 @@ public:
     Client();
     ~Client();
 
-    bool connectToServer(const std::string& ip, uint16_t port);
+    // Also asks how the server generates terrain unless localGeneration is
+    // off; see generatesLocally
+    bool connectToServer(const std::string& ip, uint16_t port, bool localGeneration = true);
     void disconnect();
 
-    // Request a single chunk; will block until received or error -> returns empty on failure
+    // Request a single chunk; will block until received or error -> chunk is null on failure
     ChunkData requestChunk(uint32_t x, uint32_t y, uint32_t z);
+    // True when this build generates terrain exactly like the server (same
+    // generator version and layout). Chunks are then generated here from the
+    // server's seed, and the server sends only the blocks edited since.
+    bool generatesLocally() const { return generator != nullptr; }
+    // The caller dropped a chunk; frees what local generation keeps of it
+    void releaseChunk(int chunkX, int chunkZ);
+    // Chunk headers and payloads received so far
+    uint64_t getBytesReceived() const { return bytesReceived; }
+    // Log the connection and every chunk received to stdout; on by default.
+    // Errors go to stderr either way.
+    void setVerbose(bool v) { verbose = v; }
   ChunkData getChunkForPosition(float x, float y, float z);
 
 private:
@@ -31,10 +45,14 @@ private:
     int currentChunkY = INT32_MIN;
     int currentChunkZ = INT32_MIN;
     bool connectTcp();
+    bool negotiateGeneration();
     void cleanup();
 
     std::string serverIP;
     uint16_t serverPort;
     socket_t tcpSocket = INVALID_SOCKET_VALUE;
     bool connected = false;
+    std::unique_ptr<ChunkManager> generator; // set when generatesLocally
+    uint64_t bytesReceived = 0;
+    bool verbose = true;
 };
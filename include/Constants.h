@@ -3,3 +3,6 @@
 #include <cstdint>
 
 inline constexpr int INVALID_SOCKET_VALUE = -1;
+
+// Where the server looks for stored chunks (see WorldStorage, tools/Pregen)
+inline constexpr const char* WORLD_DIR = "world";
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// Terrain height noise: a low-frequency Perlin base plus a small OpenSimplex2
+// detail term, sampled for a whole grid of columns per call. Every path but
+// Scalar runs a port of FastNoiseLite's 2D Perlin and OpenSimplex2 with the
+// settings below baked in at compile time; it keeps FastNoiseLite's operation
+// order, so all paths agree to within TOLERANCE (in practice bit for bit).
+// Scalar stays on FastNoiseLite's runtime-configured GetNoise as the
+// reference.
+struct HeightNoise {
+    static constexpr int BASE_SEED = 0;
+    static constexpr float BASE_FREQUENCY = 0.015f;  // very low frequency -> broad changes
+    static constexpr float BASE_AMPLITUDE = 0.2f;
+    static constexpr int DETAIL_SEED = 12345;
+    static constexpr float DETAIL_FREQUENCY = 0.08f; // small detail noise
+    static constexpr float DETAIL_AMPLITUDE = 0.05f;
+
+    static constexpr float TOLERANCE = 1e-6f;
+
+    enum class Simd : uint8_t {
+        Scalar,  // FastNoiseLite, one point per call
+        Generic, // compile-time kernel, 1 lane, any CPU
+        SSE41,   // 4 lanes
+        AVX2,    // 8 lanes
+    };
+
+    // Widest path this CPU and this build support.
+    static Simd detect();
+    static const char* name(Simd simd);
+
+    // Combined noise (base * BASE_AMPLITUDE + detail * DETAIL_AMPLITUDE) for
+    // the w x d world columns starting at (originX, originZ), x fastest. Any
+    // grid size works, so a multi-chunk region can be filled in one call.
+    // worldSeed is folded into both noise seeds; 0 gives the original terrain.
+    static void sample(int worldSeed, int originX, int originZ, int w, int d, float* out, Simd simd = detect());
+
+    // Surface y per column for chunks chunkHeight blocks tall: sample(), then
+    // the smoothing curve, then a clamp to [1, chunkHeight - 1].
+    static void fillHeights(int worldSeed, int originX, int originZ, int w, int d, int chunkHeight, int* out,
+                            Simd simd = detect());
+
+    // Per-instruction-set kernels. Each lives in its own translation unit
+    // compiled for that instruction set, and returns false when the build
+    // could not include it.
+    static bool sampleSse41(int worldSeed, int originX, int originZ, int w, int d, float* out);
+    static bool sampleAvx2(int worldSeed, int originX, int originZ, int w, int d, float* out);
+    // fillHeights' curve and clamp over n sampled values: base plus the number
+    // of ascending steps each value reaches, clamped to [1, maxHeight].
+    static bool heightsSse41(const float* noise, int n, const float* steps, int stepCount, int base, int maxHeight,
+                             int* out);
+    static bool heightsAvx2(const float* noise, int n, const float* steps, int stepCount, int base, int maxHeight,
+                            int* out);
+};
@@ -0,0 +1,234 @@
+#pragma once
+
+// Lane-generic port of FastNoiseLite's 2D Perlin and OpenSimplex2, shared by
+// the HeightNoise translation units. Each unit includes this with its own
+// Ops (vector types plus the handful of operations below) and is compiled for
+// its instruction set; everything here has internal linkage so the copies
+// built with different flags never get merged by the linker.
+//
+// Settings supplies the seeds, frequencies and amplitudes (HeightNoise's) as
+// compile-time constants, so unlike FastNoiseLite::GetNoise there is no
+// per-call dispatch on noise type, rotation or fractal.
+//
+// Ops provides: F / I vector types, W lanes, set1f/set1i, iota (0..W-1 as I),
+// add/sub/mul (F), addi/muli/xori/andi/orI/srai (I), toF (I -> F),
+// truncI (F -> I), lt/le (F mask as F), maskI (F mask -> I), select(m, a, b)
+// and selectI (pick a where the mask is set), gather(table, I), load(const
+// float*), store(float*, F) and storei(int32_t*, I).
+
+#include "HeightNoise.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+// FastNoiseLite::Lookup<float>::Gradients2D (private there)
+alignas(64) const float kGradients2D[256] = {
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+    -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+};
+
+constexpr int kPrimeX = 501125321;
+constexpr int kPrimeY = 1136930381;
+
+template <class Ops, class Settings>
+struct NoiseKernel {
+    using F = typename Ops::F;
+    using I = typename Ops::I;
+
+    // f >= 0 ? (int)f : (int)f - 1, like FastNoiseLite::FastFloor
+    static I fastFloor(F f) {
+        return Ops::addi(Ops::truncI(f), Ops::maskI(Ops::lt(f, Ops::set1f(0.0f))));
+    }
+
+    static F gradCoord(I seed, I xPrimed, I yPrimed, F xd, F yd) {
+        I hash = Ops::muli(Ops::xori(Ops::xori(seed, xPrimed), yPrimed), Ops::set1i(0x27d4eb2d));
+        hash = Ops::xori(hash, Ops::srai(hash, 15));
+        hash = Ops::andi(hash, Ops::set1i(127 << 1));
+        F xg = Ops::gather(kGradients2D, hash);
+        F yg = Ops::gather(kGradients2D, Ops::orI(hash, Ops::set1i(1)));
+        return Ops::add(Ops::mul(xd, xg), Ops::mul(yd, yg));
+    }
+
+    static F lerp(F a, F b, F t) { return Ops::add(a, Ops::mul(t, Ops::sub(b, a))); }
+
+    static F interpQuintic(F t) {
+        F inner = Ops::add(Ops::mul(t, Ops::sub(Ops::mul(t, Ops::set1f(6.0f)), Ops::set1f(15.0f))), Ops::set1f(10.0f));
+        return Ops::mul(Ops::mul(Ops::mul(t, t), t), inner);
+    }
+
+    // SinglePerlin(seed, x, y) on already-scaled coordinates
+    static F perlin(int seedValue, F x, F y) {
+        I seed = Ops::set1i(seedValue);
+        I x0 = fastFloor(x);
+        I y0 = fastFloor(y);
+
+        F xd0 = Ops::sub(x, Ops::toF(x0));
+        F yd0 = Ops::sub(y, Ops::toF(y0));
+        F xd1 = Ops::sub(xd0, Ops::set1f(1.0f));
+        F yd1 = Ops::sub(yd0, Ops::set1f(1.0f));
+
+        F xs = interpQuintic(xd0);
+        F ys = interpQuintic(yd0);
+
+        x0 = Ops::muli(x0, Ops::set1i(kPrimeX));
+        y0 = Ops::muli(y0, Ops::set1i(kPrimeY));
+        I x1 = Ops::addi(x0, Ops::set1i(kPrimeX));
+        I y1 = Ops::addi(y0, Ops::set1i(kPrimeY));
+
+        F xf0 = lerp(gradCoord(seed, x0, y0, xd0, yd0), gradCoord(seed, x1, y0, xd1, yd0), xs);
+        F xf1 = lerp(gradCoord(seed, x0, y1, xd0, yd1), gradCoord(seed, x1, y1, xd1, yd1), xs);
+
+        return Ops::mul(lerp(xf0, xf1, ys), Ops::set1f(1.4247691104677813f));
+    }
+
+    // SingleSimplex(seed, x, y) on already-skewed coordinates
+    static F simplex(int seedValue, F x, F y) {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float G2 = (3 - SQRT3) / 6;
+        const float C1 = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2));
+        const float C2 = (float)(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+
+        I seed = Ops::set1i(seedValue);
+        I i = fastFloor(x);
+        I j = fastFloor(y);
+        F xi = Ops::sub(x, Ops::toF(i));
+        F yi = Ops::sub(y, Ops::toF(j));
+
+        F t = Ops::mul(Ops::add(xi, yi), Ops::set1f(G2));
+        F x0 = Ops::sub(xi, t);
+        F y0 = Ops::sub(yi, t);
+
+        i = Ops::muli(i, Ops::set1i(kPrimeX));
+        j = Ops::muli(j, Ops::set1i(kPrimeY));
+        I iNext = Ops::addi(i, Ops::set1i(kPrimeX));
+        I jNext = Ops::addi(j, Ops::set1i(kPrimeY));
+        const F zero = Ops::set1f(0.0f);
+
+        F a = Ops::sub(Ops::sub(Ops::set1f(0.5f), Ops::mul(x0, x0)), Ops::mul(y0, y0));
+        F aa = Ops::mul(a, a);
+        F n0 = Ops::mul(Ops::mul(aa, aa), gradCoord(seed, i, j, x0, y0));
+        n0 = Ops::select(Ops::le(a, zero), zero, n0);
+
+        F c = Ops::add(Ops::mul(Ops::set1f(C1), t), Ops::add(Ops::set1f(C2), a));
+        F x2 = Ops::add(x0, Ops::set1f(2 * (float)G2 - 1));
+        F y2 = Ops::add(y0, Ops::set1f(2 * (float)G2 - 1));
+        F cc = Ops::mul(c, c);
+        F n2 = Ops::mul(Ops::mul(cc, cc), gradCoord(seed, iNext, jNext, x2, y2));
+        n2 = Ops::select(Ops::le(c, zero), zero, n2);
+
+        // the middle corner is (0, 1) above the diagonal and (1, 0) below it
+        F upper = Ops::lt(x0, y0);
+        F x1 = Ops::add(x0, Ops::select(upper, Ops::set1f((float)G2), Ops::set1f((float)G2 - 1)));
+        F y1 = Ops::add(y0, Ops::select(upper, Ops::set1f((float)G2 - 1), Ops::set1f((float)G2)));
+        I upperI = Ops::maskI(upper);
+        I i1 = Ops::selectI(upperI, i, iNext);
+        I j1 = Ops::selectI(upperI, jNext, j);
+        F b = Ops::sub(Ops::sub(Ops::set1f(0.5f), Ops::mul(x1, x1)), Ops::mul(y1, y1));
+        F bb = Ops::mul(b, b);
+        F n1 = Ops::mul(Ops::mul(bb, bb), gradCoord(seed, i1, j1, x1, y1));
+        n1 = Ops::select(Ops::le(b, zero), zero, n1);
+
+        return Ops::mul(Ops::add(Ops::add(n0, n1), n2), Ops::set1f(99.83685446303647f));
+    }
+
+    static void sample(int worldSeed, int originX, int originZ, int w, int d, float* out) {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float F2 = 0.5f * (SQRT3 - 1);
+        alignas(64) float lanes[Ops::W];
+
+        for (int z = 0; z < d; ++z) {
+            F worldZ = Ops::toF(Ops::set1i(originZ + z));
+            // z terms of both coordinate transforms are constant along the row
+            F bz = Ops::mul(worldZ, Ops::set1f(Settings::BASE_FREQUENCY));
+            F dz = Ops::mul(worldZ, Ops::set1f(Settings::DETAIL_FREQUENCY));
+            float* row = out + (size_t)z * w;
+
+            for (int x = 0; x < w; x += Ops::W) {
+                F worldX = Ops::toF(Ops::addi(Ops::iota(), Ops::set1i(originX + x)));
+
+                F bx = Ops::mul(worldX, Ops::set1f(Settings::BASE_FREQUENCY));
+                F base = perlin(Settings::BASE_SEED ^ worldSeed, bx, bz);
+
+                F dx = Ops::mul(worldX, Ops::set1f(Settings::DETAIL_FREQUENCY));
+                F skew = Ops::mul(Ops::add(dx, dz), Ops::set1f(F2));
+                F detail = simplex(Settings::DETAIL_SEED ^ worldSeed, Ops::add(dx, skew), Ops::add(dz, skew));
+
+                F combined = Ops::add(Ops::mul(base, Ops::set1f(Settings::BASE_AMPLITUDE)),
+                                      Ops::mul(detail, Ops::set1f(Settings::DETAIL_AMPLITUDE)));
+                if (x + Ops::W <= w) {
+                    Ops::store(row + x, combined);
+                } else {
+                    Ops::store(lanes, combined);
+                    for (int k = 0; x + k < w; ++k) row[x + k] = lanes[k];
+                }
+            }
+        }
+    }
+
+    // base plus the number of steps each noise value reaches, clamped to
+    // [1, maxHeight]. Steps outer per vector, so the counts stay in registers.
+    static void heights(const float* noise, int n, const float* steps, int stepCount, int base, int maxHeight,
+                        int32_t* out) {
+        alignas(64) float lanesIn[Ops::W];
+        alignas(64) int32_t lanesOut[Ops::W];
+        const F one = Ops::set1f(1.0f);
+        const F top = Ops::set1f((float)maxHeight);
+
+        for (int i = 0; i < n; i += Ops::W) {
+            bool full = i + Ops::W <= n;
+            if (!full) {
+                for (int k = 0; k < Ops::W; ++k) lanesIn[k] = i + k < n ? noise[i + k] : -1.0f;
+            }
+            F v = Ops::load(full ? noise + i : lanesIn);
+
+            // each reached step adds an all-ones (-1) mask
+            I below = Ops::set1i(0);
+            for (int k = 0; k < stepCount; ++k)
+                below = Ops::addi(below, Ops::maskI(Ops::le(Ops::set1f(steps[k]), v)));
+            F h = Ops::sub(Ops::set1f((float)base), Ops::toF(below));
+            h = Ops::select(Ops::lt(h, one), one, h);
+            h = Ops::select(Ops::lt(top, h), top, h);
+
+            if (full) {
+                Ops::storei(out + i, Ops::truncI(h));
+            } else {
+                Ops::storei(lanesOut, Ops::truncI(h));
+                for (int k = 0; i + k < n; ++k) out[i + k] = lanesOut[k];
+            }
+        }
+    }
+};
+
+} // namespace
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include "ChunkMap.h"
+
+// Picks chunks for one player that are worth generating before anyone asks:
+// rings just beyond the render distance, and the render square at points
+// ahead along the direction the player has recently been moving. Chunks
+// inside the current render square are left out; those are real requests.
+class PregenPlanner {
+public:
+    static constexpr int RINGS = 2;          // beyond the render distance
+    static constexpr int AHEAD = 8;          // chunks along the heading
+    static constexpr size_t HISTORY = 8;     // chunk changes the heading is taken over
+
+    // Call when the player enters a new chunk. Targets come soonest-needed
+    // first: by how many chunks the player must move before needing them.
+    std::vector<ChunkKey> update(ChunkKey playerChunk, int renderDistance);
+
+private:
+    std::deque<ChunkKey> history; // most recent last
+};
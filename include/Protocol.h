@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Every client message is one ClientRequest; the server answers requests in
+// the order they arrive.
+enum class RequestType : uint32_t {
+    Chunk = 0,      // ChunkPacketHeader + the chunk's blocks
+    WorldInfo = 1,  // WorldInfoPacket; coords are ignored
+    ChunkEdits = 2  // ChunkPacketHeader + only what differs from generation
+};
+
+struct ClientRequest {
+    uint32_t type; // RequestType
+    uint32_t chunkX, chunkY, chunkZ;
+};
+
+// What a client needs to generate chunks exactly as the server does. A
+// client whose GENERATOR_VERSION and SectionLayout::id match may ask for
+// ChunkEdits instead of whole chunks.
+struct WorldInfoPacket {
+    int32_t seed;
+    uint32_t generator;      // GENERATOR_VERSION
+    uint16_t chunkSize, chunkHeight;
+    uint8_t layout;          // SectionLayout::id
+    uint8_t caveSampling;    // CaveField::Sampling
+};
+
+enum class ChunkEncoding : uint8_t {
+    Blocks = 0, // payload produced by Chunk::serialize()
+    Edits = 1   // payload produced by Chunk::serializeEdits(), applied to the generated chunk
+};
+
+// Server reply to a chunk request: this header, then payloadSize bytes.
+// A ChunkEdits request may still be answered with Blocks when the chunk was
+// changed so much that sending it whole is smaller.
+struct ChunkPacketHeader {
+    uint32_t chunkX, chunkY, chunkZ;
+    uint16_t width, height, depth;
+    uint32_t payloadSize;
+    uint8_t layout;        // SectionLayout::id; dense sections are in that order
+    uint8_t encoding;      // ChunkEncoding
+};
+
+// Per-section tag in a serialized chunk. After the last section comes the
+// ramp overlay: uint16 count (little endian), then [x, y, z, rampDirection] per ramp.
+enum class SectionTag : uint8_t {
+    Uniform = 0, // followed by one blockType
+    Dense = 1    // followed by one blockType per voxel in the section
+};
+
+// A serialized edit list is uint16 count (little endian), then
+// [x, y, z, blockType, rampDirection] per edit.
@@ -2,12 +2,51 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include "ChunkMap.h"
 #include "Constants.h"
+
+// A mesh vertex in 8 bytes, decoded by shaders/vertex.glsl. Positions are
+// chunk-local and every block and ramp corner sits on a half block, so each
+// coordinate is stored as 2 * (p + 0.5) in 8 bits, for chunks up to 127
+// blocks on a side; the chunk's origin is added per draw. tex is in blocks: a
+// face merged from n blocks runs 0..n along that side, and the shader wraps
+// it into atlas tile `tile`. It is stored doubled in 12 bits per axis.
 struct Vertex {
-    glm::vec3 pos;
-    glm::vec2 tex;
+    uint32_t pos; // x | y << 8 | z << 16
+    uint32_t tex; // u | v << 12 | tile << 24
+
+    static Vertex pack(glm::vec3 p, glm::vec2 uv, int tile) {
+        auto half = [](float v) { return (uint32_t)std::lround(2.0f * v); };
+        return Vertex{half(p.x + 0.5f) | half(p.y + 0.5f) << 8 | half(p.z + 0.5f) << 16,
+                      half(uv.x) | half(uv.y) << 12 | (uint32_t)tile << 24};
+    }
+    // Added to pos, moves the vertex by whole blocks
+    static uint32_t blockOffset(int x, int y, int z) {
+        return (uint32_t)(2 * x) | (uint32_t)(2 * y) << 8 | (uint32_t)(2 * z) << 16;
+    }
+
+    glm::vec3 getPosition() const {
+        return glm::vec3((float)(pos & 0xFF), (float)(pos >> 8 & 0xFF), (float)(pos >> 16 & 0xFF)) * 0.5f -
+               glm::vec3(0.5f);
+    }
+    glm::vec2 getTexCoord() const { return glm::vec2((float)(tex & 0xFFF), (float)(tex >> 12 & 0xFFF)) * 0.5f; }
+    int getTile() const { return (int)(tex >> 24); }
+};
+
+// A chunk's geometry. Quads are four corners a, b, c, d each, drawn as the
+// triangles a, b, c and c, d, a through one index buffer all chunks share;
+// shapes that aren't quads, like the triangular sides of ramps, are three
+// vertices per triangle.
+struct ChunkMesh {
+    std::vector<Vertex> quads;
+    std::vector<Vertex> triangles;
+
+    bool empty() const { return quads.empty() && triangles.empty(); }
+    size_t vertexCount() const { return quads.size() + triangles.size(); }
 };
 
 class Renderer {
@@ -17,12 +56,17 @@ public:
              const std::string& fragmentShaderPath);
     ~Renderer();
 
+    // Draws every chunk mesh, each at its own origin
     void render();
     void setView(const glm::mat4& viewMatrix);
+    // A 1x1 cube as chunk 0,0's mesh until that chunk's arrives
     void initCube();
 
-    // Upload mesh (pos + tex) and replace any previous mesh
-    void setMesh(const std::vector<Vertex>& vertices);
+    // Upload a chunk's mesh in its own buffer, replacing any previous one.
+    // Vertex positions are chunk-local; origin is where the chunk's block
+    // (0, 0, 0) sits in the world.
+    void setChunkMesh(const ChunkKey& key, const glm::vec3& origin, const ChunkMesh& mesh);
+    void removeChunkMesh(const ChunkKey& key);
 
 private:
     // helper functions (file load, shader compile, texture load)
@@ -31,9 +75,20 @@ private:
     GLuint linkProgram(GLuint vs, GLuint fs);
     GLuint loadTexture(const std::string& path);
 
-    void createEmptyMeshBuffers(); // create VAO/VBO for mesh if not exist
+    struct ChunkBuffers {
+        GLuint VAO{0}, VBO{0};
+        glm::vec3 origin{0.0f};
+        size_t quadVertices{0};     // quad corners at the start of VBO
+        size_t triangleVertices{0}; // then the triangles
+    };
+    void createMeshBuffers(ChunkBuffers& mesh); // VAO/VBO and attribute layout
+    void deleteMeshBuffers(ChunkBuffers& mesh);
+    // Grows the shared index buffer to cover at least `quads` quads
+    void reserveQuadIndices(size_t quads);
 
-    GLuint VAO{0}, VBO{0}; // for dynamic mesh
+    ChunkMap<ChunkBuffers> meshes;
+    GLuint quadIndices{0};      // 0, 1, 2, 2, 3, 0, then the same +4 per quad
+    size_t quadIndexCapacity{0}; // quads it has indices for
     GLuint shaderProgram{0};
     GLuint texture{0};
 
@@ -42,6 +97,4 @@ private:
     glm::mat4 projection;
 
     int width, height;
-
-    size_t vertexCount{0}; // number of vertices currently in VBO
 };
@@ -3,7 +3,12 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <deque>
+#include <vector>
 #include "ChunkManager.h"
+#include "ChunkGenPool.h"
+#include "PregenPlanner.h"
+#include "Protocol.h"
 #include "Player.h"
 #include "Constants.h"
 
@@ -20,11 +25,33 @@ public:
 
     // allow server to know player's camera/player on server-side (optional)
     void setPlayer(Player* p) { player = p; }
+    // Log connections and every chunk request to stdout; on by default. Set
+    // before start(). Errors go to stderr either way.
+    void setVerbose(bool v) { verbose = v; }
 
 private:
+    // A request waiting to be answered, in arrival order. Only Chunk
+    // requests wait on generation; the others have no handle.
+    struct PendingChunk {
+        RequestType type;
+        uint32_t cx, cy, cz;
+        ChunkHandle handle;
+    };
+    struct TcpClient {
+        socket_t sock;
+        std::deque<PendingChunk> pending;
+    };
+
     void run();
     void handleUdpRequest(socket_t sock);
-    bool handleTcpRequest(socket_t clientSock);
+    // Reads one request and queues it; false if the client went away.
+    bool handleTcpRequest(TcpClient& client);
+    // Sends every finished request at the front of the client's queue.
+    bool flushPendingChunks(TcpClient& client);
+    bool sendWorldInfo(socket_t clientSock);
+    // encoding Edits sends edits unless the whole chunk is smaller
+    bool sendChunk(socket_t clientSock, uint32_t cx, uint32_t cy, uint32_t cz, const ChunkRef& ch,
+                   ChunkEncoding encoding = ChunkEncoding::Blocks, const std::vector<BlockEdit>& edits = {});
 
     socket_t createNonBlockingSocket(int type, int protocol);
 
@@ -36,5 +63,9 @@ private:
     std::atomic<socket_t> tcpSocket;
 
     std::unique_ptr<ChunkManager> chunkManager;
+    // declared after chunkManager so its workers stop before the manager goes
+    std::unique_ptr<ChunkGenPool> genPool;
+    PregenPlanner pregenPlanner;
     Player* player = nullptr;
+    bool verbose = true;
 };
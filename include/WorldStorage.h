@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "CaveField.h"
+#include "ChunkMap.h"
+
+// Complete chunks on disk as Chunk::serialize() payloads, so a server can
+// load them instead of generating (tools/Pregen fills one ahead of time).
+//
+// Chunks are grouped into region files of REGION_SIZE x REGION_SIZE chunks,
+// each starting with a table of where its chunks are. A world.dat beside
+// them records what the chunks were generated with; open() refuses a
+// directory from a different seed, chunk shape, section layout, cave
+// sampling or generator version. Saving a chunk again appends it and leaves the old copy as dead
+// space. Any number of threads may use one storage at once.
+class WorldStorage {
+public:
+    static constexpr int REGION_SIZE = 32;
+
+    WorldStorage() = default;
+    WorldStorage(const WorldStorage&) = delete;
+    WorldStorage& operator=(const WorldStorage&) = delete;
+
+    // Creates dir and its world.dat if missing. False, with the reason on
+    // stderr, if the directory can't be used for this world.
+    bool open(const std::string& dir, int32_t worldSeed, int chunkSize, int chunkHeight, CaveField::Sampling caves);
+    bool isOpen() const { return !dir.empty(); }
+
+    bool save(int chunkX, int chunkZ, const std::vector<uint8_t>& payload);
+    // False if the chunk isn't stored
+    bool load(int chunkX, int chunkZ, std::vector<uint8_t>& payload);
+    bool contains(int chunkX, int chunkZ);
+
+    // Bytes written by save() since open
+    uint64_t getBytesWritten() const;
+
+private:
+    struct Entry {
+        uint32_t offset = 0; // 0 if the chunk isn't stored
+        uint32_t size = 0;
+    };
+    struct Region {
+        std::unique_ptr<std::fstream> file;
+        std::vector<Entry> table; // REGION_SIZE * REGION_SIZE, x fastest
+    };
+
+    // The region holding a chunk, opened (and created if create) on first use
+    Region* regionFor(int chunkX, int chunkZ, bool create);
+    std::string regionPath(const ChunkKey& region) const;
+
+    std::string dir;
+    mutable std::mutex mtx; // guards regions and every file in it
+    ChunkMap<Region> regions;
+    uint64_t bytesWritten = 0;
+};
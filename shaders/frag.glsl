@@ -1,9 +1,13 @@
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoord;
+flat in vec2 Tile;
 
 uniform sampler2D texture1;
 
 void main() {
-    FragColor = texture(texture1, TexCoord);
+    // TexCoord counts blocks, so a merged face repeats the texture once per
+    // block. Mip selection uses the unwrapped coordinates; fract's jump at
+    // block edges would otherwise pick the smallest mip there.
+    FragColor = textureGrad(texture1, Tile + fract(TexCoord), dFdx(TexCoord), dFdy(TexCoord));
 }
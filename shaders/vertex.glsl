@@ -1,12 +1,18 @@
 #version 330 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aTexCoord;
+// Vertex from include/Renderer.h, packed by Vertex::pack
+layout(location = 0) in uint aPos; // x | y << 8 | z << 16, each 2 * (p + 0.5)
+layout(location = 1) in uint aTex; // u | v << 12 | tile << 24, u and v doubled
 
 out vec2 TexCoord;
+flat out vec2 Tile;
 
 uniform mat4 uMVP;
+uniform vec3 uChunkOrigin;
+uniform float uAtlasTiles;
 
 void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
+    vec3 local = vec3(uvec3(aPos, aPos >> 8u, aPos >> 16u) & 0xFFu) * 0.5 - 0.5;
+    gl_Position = uMVP * vec4(uChunkOrigin + local, 1.0);
+    TexCoord = vec2(uvec2(aTex, aTex >> 12u) & 0xFFFu) * 0.5;
+    Tile = vec2(float(aTex >> 24u) / uAtlasTiles, 0.0);
 }
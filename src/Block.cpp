@@ -1,12 +1,16 @@
 
 #include "Block.h"
-// Updated texture coordinate function to handle BlockType instead of Block
-glm::vec2 getTextureCoordForBlock(BlockType blockType) {
+int getTileIndexForBlock(BlockType blockType) {
     switch (blockType) {
-        case BlockType::Grass: return {0.0f, 0.0f};
-        case BlockType::Stone: return {0.25f, 0.0f};
-        case BlockType::Dirt:  return {0.5f, 0.0f};
-        case BlockType::Ore:   return {0.75f, 0.0f};
-        default: return {0.0f, 0.0f};
+        case BlockType::Grass: return 0;
+        case BlockType::Stone: return 1;
+        case BlockType::Dirt:  return 2;
+        case BlockType::Ore:   return 3;
+        default: return 0;
     }
 }
+
+// Updated texture coordinate function to handle BlockType instead of Block
+glm::vec2 getTextureCoordForBlock(BlockType blockType) {
+    return {(float)getTileIndexForBlock(blockType) / ATLAS_TILES, 0.0f};
+}
@@ -0,0 +1,136 @@
+#include "BlockBufferPool.h"
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+BlockBufferPool& BlockBufferPool::instance() {
+    // Deliberately never destroyed: chunks held by other statics may release
+    // buffers during exit.
+    static BlockBufferPool* pool = new BlockBufferPool();
+    return *pool;
+}
+
+void BlockBufferPool::setUseHugePages(bool enable) {
+    std::lock_guard<std::mutex> lk(mtx);
+    hugePages = enable;
+}
+
+int BlockBufferPool::sizeClass(size_t words) {
+    int c = 0;
+    while (((size_t)1 << c) < words) ++c;
+    return c;
+}
+
+uint64_t* BlockBufferPool::carveFromSlab(size_t capacity) {
+    size_t bytes = capacity * sizeof(uint64_t);
+    if (bytes > SLAB_BYTES) return nullptr;
+    if (slabRemaining < bytes) {
+        void* base = nullptr;
+#ifndef _WIN32
+#ifdef MAP_HUGETLB
+        base = mmap(nullptr, SLAB_BYTES, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == MAP_FAILED) base = nullptr;
+#endif
+        if (!base) {
+            // No reserved huge pages: map twice the size, trim to a 2 MB
+            // aligned slab and ask for transparent huge pages instead.
+            void* raw = mmap(nullptr, SLAB_BYTES * 2, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw != MAP_FAILED) {
+                uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+                uintptr_t aligned = (start + SLAB_BYTES - 1) & ~(uintptr_t)(SLAB_BYTES - 1);
+                if (aligned > start) munmap(raw, aligned - start);
+                size_t tail = start + SLAB_BYTES * 2 - (aligned + SLAB_BYTES);
+                if (tail) munmap(reinterpret_cast<void*>(aligned + SLAB_BYTES), tail);
+                base = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+                madvise(base, SLAB_BYTES, MADV_HUGEPAGE);
+#endif
+            }
+        }
+#endif
+        if (!base) base = ::operator new(SLAB_BYTES);
+        slabs.push_back(base);
+        // the tail of the previous slab is abandoned; classes are small next to 2 MB
+        slabCursor = static_cast<char*>(base);
+        slabRemaining = SLAB_BYTES;
+    }
+    uint64_t* out = reinterpret_cast<uint64_t*>(slabCursor);
+    slabCursor += bytes;
+    slabRemaining -= bytes;
+    return out;
+}
+
+uint64_t* BlockBufferPool::acquire(size_t words, size_t& capacity) {
+    int c = sizeClass(words);
+    capacity = (size_t)1 << c;
+    uint64_t* buf = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stats.requests++;
+        if ((size_t)c < freeLists.size() && !freeLists[c].empty()) {
+            buf = freeLists[c].back();
+            freeLists[c].pop_back();
+            stats.hits++;
+        } else if (hugePages) {
+            buf = carveFromSlab(capacity);
+        }
+        if (!buf) buf = new uint64_t[capacity];
+        stats.inUse++;
+        if (stats.inUse > stats.highWater) stats.highWater = stats.inUse;
+    }
+    std::memset(buf, 0, capacity * sizeof(uint64_t));
+    return buf;
+}
+
+void BlockBufferPool::release(uint64_t* buf, size_t capacity) {
+    if (!buf) return;
+    int c = sizeClass(capacity);
+    std::lock_guard<std::mutex> lk(mtx);
+    if ((size_t)c >= freeLists.size()) freeLists.resize(c + 1);
+    freeLists[c].push_back(buf);
+    stats.inUse--;
+}
+
+PoolStats BlockBufferPool::getStats() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return stats;
+}
+
+BlockBuffer::BlockBuffer(size_t words) : count(words) {
+    if (words) data = BlockBufferPool::instance().acquire(words, cap);
+}
+
+BlockBuffer::BlockBuffer(const BlockBuffer& o) : BlockBuffer(o.count) {
+    if (count) std::memcpy(data, o.data, count * sizeof(uint64_t));
+}
+
+BlockBuffer::BlockBuffer(BlockBuffer&& o) noexcept
+    : data(o.data), count(o.count), cap(o.cap) {
+    o.data = nullptr;
+    o.count = o.cap = 0;
+}
+
+BlockBuffer& BlockBuffer::operator=(BlockBuffer o) noexcept {
+    swap(o);
+    return *this;
+}
+
+BlockBuffer::~BlockBuffer() { clear(); }
+
+void BlockBuffer::swap(BlockBuffer& o) noexcept {
+    std::swap(data, o.data);
+    std::swap(count, o.count);
+    std::swap(cap, o.cap);
+}
+
+void BlockBuffer::clear() {
+    if (data) BlockBufferPool::instance().release(data, cap);
+    data = nullptr;
+    count = cap = 0;
+}
@@ -0,0 +1,85 @@
+#include "BlockStorage.h"
+#include <algorithm>
+
+BlockStorage::BlockStorage(size_t volume_) : volume(volume_), palette(1, BlockType::Air) {}
+
+int BlockStorage::bitsForPaletteSize(size_t n) {
+    int b = 0;
+    while (((size_t)1 << b) < n) ++b;
+    return b;
+}
+
+BlockType BlockStorage::get(size_t i) const {
+    if (bits == 0) return palette[0];
+    return palette[readIndex(i)];
+}
+
+void BlockStorage::set(size_t i, BlockType b) {
+    if (bits == 0 && palette[0] == b) return;
+    uint32_t p = findOrAddPaletteEntry(b);
+    writeIndex(i, p);
+}
+
+void BlockStorage::unpack(BlockType* out) const {
+    if (bits == 0) {
+        std::fill(out, out + volume, palette[0]);
+        return;
+    }
+    const uint64_t mask = (1ull << bits) - 1;
+    size_t i = 0;
+    for (size_t wi = 0; i < volume; ++wi) {
+        uint64_t w = words[wi];
+        for (int k = 0; k < indicesPerWord && i < volume; ++k, w >>= bits) out[i++] = palette[w & mask];
+    }
+}
+
+void BlockStorage::fill(BlockType b) {
+    palette.assign(1, b);
+    words.clear();
+    bits = 0;
+    indicesPerWord = 0;
+}
+
+size_t BlockStorage::getMemoryUsage() const {
+    return palette.capacity() * sizeof(BlockType) + words.capacity() * sizeof(uint64_t);
+}
+
+uint32_t BlockStorage::findOrAddPaletteEntry(BlockType b) {
+    for (size_t p = 0; p < palette.size(); ++p) {
+        if (palette[p] == b) return (uint32_t)p;
+    }
+    palette.push_back(b);
+    int needed = bitsForPaletteSize(palette.size());
+    if (needed > bits) resize(needed);
+    return (uint32_t)(palette.size() - 1);
+}
+
+void BlockStorage::resize(int newBits) {
+    // Indices never straddle a word boundary, so a width of e.g. 3 bits
+    // wastes the top bit of each word but keeps reads to a single load.
+    int newPerWord = 64 / newBits;
+    BlockBuffer newWords((volume + newPerWord - 1) / newPerWord);
+    uint64_t mask = (1ull << newBits) - 1;
+
+    for (size_t i = 0; i < volume; ++i) {
+        uint64_t v = bits == 0 ? 0 : readIndex(i);
+        newWords[i / newPerWord] |= (v & mask) << ((i % newPerWord) * newBits);
+    }
+
+    words.swap(newWords);
+    bits = newBits;
+    indicesPerWord = newPerWord;
+}
+
+uint32_t BlockStorage::readIndex(size_t i) const {
+    uint64_t w = words[i / indicesPerWord];
+    int shift = (int)(i % indicesPerWord) * bits;
+    return (uint32_t)((w >> shift) & ((1ull << bits) - 1));
+}
+
+void BlockStorage::writeIndex(size_t i, uint32_t v) {
+    uint64_t& w = words[i / indicesPerWord];
+    int shift = (int)(i % indicesPerWord) * bits;
+    uint64_t mask = ((1ull << bits) - 1) << shift;
+    w = (w & ~mask) | (((uint64_t)v << shift) & mask);
+}
@@ -0,0 +1,85 @@
+#include "CaveField.h"
+#include "CaveNoiseKernel.h"
+// third-party: at -O2 GCC flags the unrolled neighbour loops of its cellular
+// noise, which this file never uses
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggressive-loop-optimizations"
+#include <FastNoiseLite.h>
+#pragma GCC diagnostic pop
+
+using CaveNoise = OpenSimplex3Kernel<CaveField>;
+
+static int floorDiv(int v, int d) { return v >= 0 ? v / d : (v + 1) / d - 1; }
+
+CaveField::CaveField(int worldSeed, int originX_, int originZ_, int w, int d, int maxY, Sampling sampling_,
+                     int latticeXZ, int latticeY, Kernel kernel)
+    : seed(SEED ^ worldSeed), sampling(sampling_), originX(originX_), originZ(originZ_), width(w), depth(d),
+      ySize(maxY + 1) {
+    if (kernel == Kernel::Runtime) {
+        noise = std::make_unique<FastNoiseLite>(seed);
+        noise->SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+        noise->SetFrequency(FREQUENCY);
+    }
+
+    if (sampling == Sampling::Lattice && maxY >= 0 && w > 0 && d > 0) fillFromLattice(latticeXZ, latticeY);
+}
+
+CaveField::~CaveField() = default;
+
+float CaveField::noiseAt(int worldX, int y, int worldZ) const {
+    ++samples;
+    if (noise) return noise->GetNoise((float)worldX, (float)y * 2.0f, (float)worldZ);
+    return CaveNoise::noise(seed, (float)worldX, (float)y * 2.0f, (float)worldZ);
+}
+
+void CaveField::fillFromLattice(int latticeXZ, int latticeY) {
+    // world-aligned grid points enclosing the chunk, upper edges included
+    int gx0 = floorDiv(originX, latticeXZ);
+    int gz0 = floorDiv(originZ, latticeXZ);
+    int nx = floorDiv(originX + width - 1, latticeXZ) - gx0 + 2;
+    int nz = floorDiv(originZ + depth - 1, latticeXZ) - gz0 + 2;
+    int ny = (ySize - 1) / latticeY + 2;
+
+    // lattice values, y fastest
+    std::vector<float> lattice((size_t)nx * ny * nz);
+    for (int iz = 0; iz < nz; ++iz)
+        for (int ix = 0; ix < nx; ++ix)
+            for (int iy = 0; iy < ny; ++iy)
+                lattice[(size_t)iy + (size_t)ny * (ix + (size_t)nx * iz)] =
+                    noiseAt((gx0 + ix) * latticeXZ, iy * latticeY, (gz0 + iz) * latticeXZ);
+
+    // Separable trilinear interpolation: along y for each lattice column,
+    // then x, then z. Each step depends only on world position, so two
+    // chunks agree on every voxel they could both see.
+    auto lerp = [](float a, float b, float t) { return a + t * (b - a); };
+    std::vector<float> cols((size_t)ySize * nx * nz);
+    for (size_t c = 0; c < (size_t)nx * nz; ++c) {
+        const float* in = &lattice[c * ny];
+        float* out = &cols[c * ySize];
+        for (int y = 0; y < ySize; ++y)
+            out[y] = lerp(in[y / latticeY], in[y / latticeY + 1], (float)(y % latticeY) / latticeY);
+    }
+
+    std::vector<float> rows((size_t)ySize * width * nz);
+    for (int iz = 0; iz < nz; ++iz)
+        for (int x = 0; x < width; ++x) {
+            int fx = originX + x - gx0 * latticeXZ;
+            float tx = (float)(fx % latticeXZ) / latticeXZ;
+            const float* a = &cols[(size_t)ySize * (fx / latticeXZ + (size_t)nx * iz)];
+            const float* b = a + ySize;
+            float* out = &rows[(size_t)ySize * (x + (size_t)width * iz)];
+            for (int y = 0; y < ySize; ++y) out[y] = lerp(a[y], b[y], tx);
+        }
+
+    dense.resize((size_t)ySize * width * depth);
+    for (int z = 0; z < depth; ++z) {
+        int fz = originZ + z - gz0 * latticeXZ;
+        float tz = (float)(fz % latticeXZ) / latticeXZ;
+        for (int x = 0; x < width; ++x) {
+            const float* a = &rows[(size_t)ySize * (x + (size_t)width * (fz / latticeXZ))];
+            const float* b = a + (size_t)ySize * width;
+            float* out = &dense[(size_t)ySize * (x + (size_t)width * z)];
+            for (int y = 0; y < ySize; ++y) out[y] = lerp(a[y], b[y], tz);
+        }
+    }
+}
@@ -1,222 +1,382 @@
 #include "Chunk.h"
-#include <FastNoiseLite.h>
+#include "Protocol.h"
+#include "ChunkRandom.h"
 #include <cmath>
-#include <cstdlib>
 #include <glm/glm.hpp>
-#include <iostream>
 #include <algorithm>
 Chunk::Chunk(int chunkX, int chunkZ, int w, int h, int d)
     : cx(chunkX), cz(chunkZ), width(w), height(h), depth(d),
-      blocks((size_t)w * h * d, Block{}) {}
+      sections((h + SECTION_HEIGHT - 1) / SECTION_HEIGHT),
+      heightmap((size_t)w * d, -1), solidColumns((size_t)w * d, 0), layerSolidCount((size_t)h, 0) {
+    for (auto &sec : sections) sec.storage = BlockStorage(sectionVolume());
+}
 
 Chunk::Chunk(int chunkX, int chunkZ, int w, int h, int d,
              const std::vector<uint8_t> &blockData)
-    : cx(chunkX), cz(chunkZ), width(w), height(h), depth(d) {
-  blocks.reserve(blockData.size());
-  for (auto b : blockData) {
-    Block blk;
-    blk.type = static_cast<BlockType>(b);
-    blk.ramp = RampDirection::None;
-    blocks.push_back(blk);
+    : Chunk(chunkX, chunkZ, w, h, d) {
+  deserialize(blockData);
+}
+
+void Chunk::deserialize(const std::vector<uint8_t> &blockData) {
+  reset(cx, cz);
+  size_t pos = 0;
+  const size_t vol = sectionVolume();
+  for (auto &sec : sections) {
+    if (pos >= blockData.size()) break;
+    auto tag = static_cast<SectionTag>(blockData[pos++]);
+    if (tag == SectionTag::Uniform) {
+      if (pos + 1 > blockData.size()) break;
+      sec.uniform = static_cast<BlockType>(blockData[pos]);
+      pos += 1;
+    } else {
+      if (pos + vol > blockData.size()) break;
+      sec.dense = true;
+      for (size_t i = 0; i < vol; ++i)
+        sec.storage.set(i, static_cast<BlockType>(blockData[pos + i]));
+      pos += vol;
+    }
   }
+
+  if (pos + 2 <= blockData.size()) {
+    size_t count = blockData[pos] | (blockData[pos + 1] << 8);
+    pos += 2;
+    for (size_t r = 0; r < count && pos + 4 <= blockData.size(); ++r, pos += 4)
+      setRamp(blockData[pos], blockData[pos + 1], blockData[pos + 2],
+              static_cast<RampDirection>(blockData[pos + 3]));
+  }
+  rebuildHeightmap();
+}
+
+void Chunk::reset(int chunkX, int chunkZ) {
+    cx = chunkX;
+    cz = chunkZ;
+    for (auto &sec : sections) {
+        sec.uniform = BlockType::Air;
+        sec.dense = false;
+        sec.storage.fill(BlockType::Air);
+    }
+    ramps.clear();
+    std::fill(heightmap.begin(), heightmap.end(), (int16_t)-1);
+    std::fill(solidColumns.begin(), solidColumns.end(), 0);
+    std::fill(layerSolidCount.begin(), layerSolidCount.end(), (uint16_t)0);
+    minSolidY = maxSolidY = -1;
 }
 
+BlockType Chunk::getBlockType(int x, int y, int z) const {
+    const ChunkSection &sec = sections[y / SECTION_HEIGHT];
+    if (!sec.dense) return sec.uniform;
+    return sec.storage.get(sectionIndex(x, y % SECTION_HEIGHT, z));
+}
 
+static bool rampLess(const RampEntry &r, int x, int y, int z) {
+    if (r.z != z) return r.z < z;
+    if (r.y != y) return r.y < y;
+    return r.x < x;
+}
 
-void Chunk::generateSimpleTerrain() {
-    FastNoiseLite baseNoise;
-    baseNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    baseNoise.SetFrequency(0.015f);  // Very low frequency → broad changes
-    baseNoise.SetFractalOctaves(2);  // Slight complexity
-    baseNoise.SetSeed(0);
+RampDirection Chunk::getRamp(int x, int y, int z) const {
+    if (ramps.empty()) return RampDirection::None;
+    auto it = std::lower_bound(ramps.begin(), ramps.end(), 0,
+        [&](const RampEntry &r, int) { return rampLess(r, x, y, z); });
+    if (it != ramps.end() && it->x == x && it->y == y && it->z == z) return it->dir;
+    return RampDirection::None;
+}
 
-    FastNoiseLite detailNoise;
-    detailNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    detailNoise.SetFrequency(0.08f); // Small detail noise
-    detailNoise.SetFractalOctaves(1);
-    detailNoise.SetSeed(12345);
+void Chunk::setRamp(int x, int y, int z, RampDirection dir) {
+    auto it = std::lower_bound(ramps.begin(), ramps.end(), 0,
+        [&](const RampEntry &r, int) { return rampLess(r, x, y, z); });
+    bool found = it != ramps.end() && it->x == x && it->y == y && it->z == z;
+    if (dir == RampDirection::None) {
+        if (found) ramps.erase(it);
+    } else if (found) {
+        it->dir = dir;
+    } else {
+        ramps.insert(it, RampEntry{(uint8_t)x, (uint8_t)y, (uint8_t)z, dir});
+    }
+}
 
-    FastNoiseLite caveNoise;
-    caveNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    caveNoise.SetFrequency(0.12f);
-    caveNoise.SetSeed(54321);
+void Chunk::setBlock(int x, int y, int z, Block b) {
+    // air never carries a shape
+    if (b.type == BlockType::Air) b.ramp = RampDirection::None;
+    if (b.ramp != RampDirection::None || !ramps.empty()) setRamp(x, y, z, b.ramp);
 
-    for (int x = 0; x < width; ++x) {
-        for (int z = 0; z < depth; ++z) {
-            int worldX = cx * width + x;
-            int worldZ = cz * depth + z;
-
-            // Gentle base height variation
-            float heightNoise = baseNoise.GetNoise((float)worldX, (float)worldZ) * 0.2f; // small amplitude but not zero
-
-            // Minimal fine detail
-            float detail = detailNoise.GetNoise((float)worldX, (float)worldZ) * 0.05f;
-
-            float combinedNoise = heightNoise + detail;
-
-            // Gentle smoothing curve
-            combinedNoise = powf(combinedNoise * 0.5f + 0.5f, 1.1f) * 2.0f - 1.0f;
-
-            // Mostly flat with gentle undulations
-            int terrainHeight = (int)((combinedNoise + 1.0f) * 0.5f * (height * 0.2f)) + height * 0.5f;
-            terrainHeight = std::max(1, std::min(terrainHeight, height - 1));
-
-            for (int y = 0; y < height; ++y) {
-                size_t idx = x + width * (y + height * z);
-
-                if (y < terrainHeight - 3) {
-                    float caveVal = caveNoise.GetNoise((float)worldX, (float)y * 2.0f, (float)worldZ);
-                    if (caveVal > 0.4f) {
-                        blocks[idx].type = BlockType::Air;
-                        blocks[idx].ramp = RampDirection::None;
-                        continue;
-                    }
-                }
-
-                if (y > terrainHeight) {
-                    blocks[idx].type = BlockType::Air;
-                    blocks[idx].ramp = RampDirection::None;
-                } else if (y == terrainHeight) {
-                    blocks[idx].type = BlockType::Grass;
-                } else if (y >= terrainHeight - 2) {
-                    blocks[idx].type = BlockType::Dirt;
-                } else {
-                    blocks[idx].type = BlockType::Stone;
-                    if (rand() % 100 < 2) { // rarer ores
-                        blocks[idx].type = BlockType::Ore;
-                    }
-                }
-            }
+    ChunkSection &sec = sections[y / SECTION_HEIGHT];
+    int i = sectionIndex(x, y % SECTION_HEIGHT, z);
+    BlockType old = sec.dense ? sec.storage.get(i) : sec.uniform;
+    if (old == b.type) return;
+
+    if (!sec.dense) {
+        sec.storage.fill(sec.uniform);
+        sec.dense = true;
+    }
+    sec.storage.set(i, b.type);
+
+    bool wasSolid = old != BlockType::Air;
+    bool isSolid = b.type != BlockType::Air;
+    if (wasSolid != isSolid) updateHeightmap(x, y, z, isSolid);
+}
+
+void Chunk::updateHeightmap(int x, int y, int z, bool solid) {
+    int16_t &top = heightmap[x + width * z];
+    if (y < 64) {
+        uint64_t &column = solidColumns[x + width * z];
+        column = solid ? column | 1ull << y : column & ~(1ull << y);
+    }
+    if (solid) {
+        if (y > top) top = (int16_t)y;
+        if (layerSolidCount[y]++ == 0) {
+            if (y > maxSolidY) maxSolidY = y;
+            if (minSolidY < 0 || y < minSolidY) minSolidY = y;
+        }
+        return;
+    }
+
+    // only removing the top block of a column needs a rescan, and only below it
+    if (y == top) {
+        int ny = y - 1;
+        while (ny >= 0 && getBlockType(x, ny, z) == BlockType::Air) --ny;
+        top = (int16_t)ny;
+    }
+    if (--layerSolidCount[y] == 0 && (y == minSolidY || y == maxSolidY))
+        recomputeSolidRange();
+}
+
+// bits of section s's layers that lie inside the chunk
+static uint64_t sectionBits(int s, int height) {
+    const int yBase = s * Chunk::SECTION_HEIGHT;
+    const int layers = std::min(Chunk::SECTION_HEIGHT, height - yBase);
+    return (layers >= 64 ? ~0ull : (1ull << layers) - 1) << yBase;
+}
+
+void Chunk::getTypeColumns(uint64_t *out) const {
+    const size_t columns = (size_t)width * depth;
+    std::fill(out, out + columns * BLOCK_TYPE_COUNT, 0);
+    std::vector<BlockType> dense;
+    for (int s = 0; s < getSectionCount(); ++s) {
+        const ChunkSection &sec = sections[s];
+        if (sec.isUniform()) {
+            uint64_t *plane = out + (size_t)sec.uniform * columns;
+            const uint64_t bits = sectionBits(s, height);
+            for (size_t c = 0; c < columns; ++c) plane[c] |= bits;
+            continue;
+        }
+        dense.resize(sec.storage.size());
+        sec.storage.unpack(dense.data());
+        // a layer at a time, so consecutive updates go to different columns
+        // instead of queueing on one column's word
+        const int yBase = s * SECTION_HEIGHT;
+        for (int ly = 0; ly < SECTION_HEIGHT && yBase + ly < height; ++ly) {
+            const uint64_t bit = 1ull << (yBase + ly);
+            for (int z = 0; z < depth; ++z)
+                for (int x = 0; x < width; ++x)
+                    out[(size_t)dense[sectionIndex(x, ly, z)] * columns + x + (size_t)width * z] |= bit;
+        }
+    }
+}
+
+void Chunk::rebuildHeightmap() {
+    std::fill(heightmap.begin(), heightmap.end(), (int16_t)-1);
+    std::fill(solidColumns.begin(), solidColumns.end(), 0);
+    std::fill(layerSolidCount.begin(), layerSolidCount.end(), (uint16_t)0);
+    for (int s = 0; s < getSectionCount(); ++s) {
+        if (sections[s].isEmpty()) continue;
+        forEachInSection(s, [&](int x, int y, int z, BlockType t) {
+            if (t == BlockType::Air) return;
+            int16_t &top = heightmap[x + width * z];
+            if (y > top) top = (int16_t)y;
+            if (y < 64) solidColumns[x + width * z] |= 1ull << y;
+            layerSolidCount[y]++;
+        });
+    }
+    recomputeSolidRange();
+}
+
+void Chunk::recomputeSolidRange() {
+    minSolidY = maxSolidY = -1;
+    for (int y = 0; y < height; ++y) {
+        if (layerSolidCount[y] == 0) continue;
+        if (minSolidY < 0) minSolidY = y;
+        maxSolidY = y;
+    }
+}
+
+void Chunk::compactSections() {
+    for (auto &sec : sections) {
+        if (!sec.dense) continue;
+        BlockType first = sec.storage.get(0);
+        bool uniform = true;
+        for (size_t i = 1; i < sec.storage.size() && uniform; ++i)
+            uniform = sec.storage.get(i) == first;
+        if (uniform) {
+            sec.uniform = first;
+            sec.dense = false;
+            sec.storage.fill(first);
+        }
+    }
+}
+
+std::vector<uint8_t> Chunk::serialize() const {
+    std::vector<uint8_t> out;
+    const size_t vol = sectionVolume();
+    for (const auto &sec : sections) {
+        if (sec.isUniform()) {
+            // empty and single-type sections cost two bytes on the wire
+            out.push_back(static_cast<uint8_t>(SectionTag::Uniform));
+            out.push_back(static_cast<uint8_t>(sec.uniform));
+            continue;
         }
+        out.push_back(static_cast<uint8_t>(SectionTag::Dense));
+        size_t start = out.size();
+        out.resize(start + vol);
+        for (size_t i = 0; i < vol; ++i)
+            out[start + i] = static_cast<uint8_t>(sec.storage.get(i));
+    }
+
+    out.push_back((uint8_t)(ramps.size() & 0xFF));
+    out.push_back((uint8_t)(ramps.size() >> 8));
+    for (const auto &r : ramps) {
+        out.push_back(r.x);
+        out.push_back(r.y);
+        out.push_back(r.z);
+        out.push_back(static_cast<uint8_t>(r.dir));
     }
+    return out;
+}
+
+std::vector<uint8_t> Chunk::serializeEdits(const std::vector<BlockEdit> &edits) {
+    std::vector<uint8_t> out;
+    out.reserve(2 + 5 * edits.size());
+    out.push_back((uint8_t)(edits.size() & 0xFF));
+    out.push_back((uint8_t)(edits.size() >> 8));
+    for (const auto &e : edits) {
+        out.push_back(e.x);
+        out.push_back(e.y);
+        out.push_back(e.z);
+        out.push_back(static_cast<uint8_t>(e.block.type));
+        out.push_back(static_cast<uint8_t>(e.block.ramp));
+    }
+    return out;
+}
+
+bool Chunk::applyEdits(const std::vector<uint8_t> &payload) {
+    if (payload.size() < 2) return false;
+    size_t count = payload[0] | (payload[1] << 8);
+    if (payload.size() != 2 + 5 * count) return false;
+    for (size_t i = 0, pos = 2; i < count; ++i, pos += 5)
+        if (payload[pos] >= width || payload[pos + 1] >= height || payload[pos + 2] >= depth) return false;
+    for (size_t i = 0, pos = 2; i < count; ++i, pos += 5)
+        setBlock(payload[pos], payload[pos + 1], payload[pos + 2],
+                 Block{static_cast<BlockType>(payload[pos + 3]), static_cast<RampDirection>(payload[pos + 4])});
+    return true;
+}
 
-    addRampsToTerrain();
+size_t Chunk::getMemoryUsage() const {
+    size_t total = sizeof(Chunk) + sections.capacity() * sizeof(ChunkSection) +
+                   ramps.capacity() * sizeof(RampEntry);
+    for (const auto &sec : sections) total += sec.storage.getMemoryUsage();
+    return total;
 }
 
 
 
-void Chunk::addRampsToTerrain() {
-    auto getTopHeight = [&](int x, int z) -> int {
-        if (x < 0 || x >= width || z < 0 || z >= depth)
-            return -1;
-        for (int y = height - 1; y >= 0; --y) {
-            size_t idx = x + width * (y + height * z);
-            if (blocks[idx].type != BlockType::Air) {
-                return y;
+void Chunk::carveTerrain(int32_t worldSeed, const int* columnHeight, CaveField::Sampling caves) {
+    int maxTerrainHeight = *std::max_element(columnHeight, columnHeight + (size_t)width * depth);
+
+    // caves only reach up to 4 below the surface
+    CaveField caveField(worldSeed, cx * width, cz * depth, width, depth, maxTerrainHeight - 4, caves);
+    ChunkRandom ores(worldSeed, cx, cz, ChunkRandom::Ores);
+
+    // Fill voxels section by section in storage order. Sections wholly above
+    // the stone are already air and stay a tag.
+    for (int s = 0; s * SECTION_HEIGHT <= maxTerrainHeight - 3 && s < getSectionCount(); ++s) {
+        const int yBase = s * SECTION_HEIGHT;
+        SectionLayout::forEach(width, SECTION_HEIGHT, depth, [&](int x, int ly, int z, size_t) {
+            int y = yBase + ly;
+            if (y >= height) return;
+            int terrainHeight = columnHeight[x + width * z];
+            if (y > terrainHeight - 3) return;
+            if (y < terrainHeight - 3 && caveField.isCave(x, y, z)) return;
+
+            Block blk;
+            blk.type = BlockType::Stone;
+            // keyed by logical voxel index, so independent of SectionLayout
+            if (ores.below((uint64_t)x + width * (y + (uint64_t)height * z), 100) < 2) { // rarer ores
+                blk.type = BlockType::Ore;
+            }
+            setBlock(x, y, z, blk);
+        });
+    }
+}
+
+void Chunk::coverSurface(const int* columnHeight) {
+    for (int z = 0; z < depth; ++z) {
+        for (int x = 0; x < width; ++x) {
+            int terrainHeight = columnHeight[x + width * z];
+            for (int y = std::max(0, terrainHeight - 2); y <= terrainHeight; ++y) {
+                Block blk;
+                blk.type = y == terrainHeight ? SURFACE_TYPE : BlockType::Dirt;
+                setBlock(x, y, z, blk);
             }
         }
-        return -1;
-    };
+    }
+}
 
-    auto isAir = [&](int x, int y, int z) -> bool {
-        if (x < 0 || x >= width || z < 0 || z >= depth || y < 0 || y >= height)
-            return false;
-        size_t idx = x + width * (y + height * z);
-        return blocks[idx].type == BlockType::Air;
+ChunkSurface Chunk::getSurface() const {
+    ChunkSurface s;
+    s.height.assign(heightmap.begin(), heightmap.end());
+    s.top.assign(heightmap.size(), BlockType::Air);
+    for (int z = 0; z < depth; ++z)
+        for (int x = 0; x < width; ++x) {
+            int h = heightmap[x + width * z];
+            if (h >= 0) s.top[x + width * z] = getBlockType(x, h, z);
+        }
+    return s;
+}
+
+void Chunk::addRamps(const ChunkSurface* const around[9]) {
+    // Pre-ramp top of a column in local coords, reaching one column into each
+    // neighbour; -1 where there is no column. Every chunk reads the same
+    // pre-ramp surfaces, so the two sides of a border agree.
+    auto surfaceAt = [&](int x, int z, BlockType* top) -> int {
+        int dx = x < 0 ? -1 : x >= width ? 1 : 0;
+        int dz = z < 0 ? -1 : z >= depth ? 1 : 0;
+        const ChunkSurface* s = around[(dx + 1) + 3 * (dz + 1)];
+        if (!s) return -1;
+        size_t i = (size_t)(x - dx * width) + (size_t)width * (z - dz * depth);
+        if (top) *top = s->top[i];
+        return s->height[i];
     };
 
     struct Direction {
         int dx, dz;
         RampDirection rampDir;
-        const char* name;
     };
 
-    // Separate cardinal and diagonal directions
-    Direction cardinalDirs[] = {
-        {0, -1, RampDirection::North, "North"},
-        {0, 1, RampDirection::South, "South"},
-        {1, 0, RampDirection::East, "East"},
-        {-1, 0, RampDirection::West, "West"}
+    // Direction from the higher column to the ramp; cardinal ones win over diagonals
+    const Direction dirs[] = {
+        {0, -1, RampDirection::North},
+        {0, 1, RampDirection::South},
+        {1, 0, RampDirection::East},
+        {-1, 0, RampDirection::West},
+        {1, -1, RampDirection::NorthEast},
+        {-1, -1, RampDirection::NorthWest},
+        {1, 1, RampDirection::SouthEast},
+        {-1, 1, RampDirection::SouthWest}
     };
 
-    Direction diagonalDirs[] = {
-        {1, -1, RampDirection::NorthEast, "NorthEast"},
-        {-1, -1, RampDirection::NorthWest, "NorthWest"},
-        {1, 1, RampDirection::SouthEast, "SouthEast"},
-        {-1, 1, RampDirection::SouthWest, "SouthWest"}
-    };
-
-    std::vector<std::vector<bool>> rampPlaced(width, std::vector<bool>(depth, false));
-
-    // For each position in the chunk
+    // Each column of this chunk takes at most one ramp, on top of itself,
+    // climbing to a neighbour exactly one block higher.
     for (int x = 0; x < width; ++x) {
         for (int z = 0; z < depth; ++z) {
-            if (rampPlaced[x][z]) continue;
-            
-            int currentHeight = getTopHeight(x, z);
-            if (currentHeight == -1) continue;
-
-            bool placedRamp = false;
-
-            // FIRST: Try cardinal directions (N, S, E, W)
-            for (auto& dir : cardinalDirs) {
-                int neighborX = x + dir.dx;
-                int neighborZ = z + dir.dz;
-                
-                if (neighborX < 0 || neighborX >= width || neighborZ < 0 || neighborZ >= depth)
-                    continue;
-                
-                if (rampPlaced[neighborX][neighborZ]) continue;
-                
-                int neighborHeight = getTopHeight(neighborX, neighborZ);
-                if (neighborHeight == -1) continue;
-                
-                int heightDiff = currentHeight - neighborHeight;
-                
-                if (heightDiff == 1) {
-                    if (isAir(neighborX, neighborHeight + 1, neighborZ)) {
-                        size_t currentIdx = x + width * (currentHeight + height * z);
-                        BlockType materialType = blocks[currentIdx].type;
-                        
-                        size_t rampIdx = neighborX + width * ((neighborHeight + 1) + height * neighborZ);
-                        blocks[rampIdx].type = materialType;
-                        blocks[rampIdx].ramp = dir.rampDir;
-                        rampPlaced[neighborX][neighborZ] = true;
-                        
-                        std::cout << "Placed " << dir.name << " ramp at (" 
-                                  << neighborX << ", " << (neighborHeight + 1) << ", " << neighborZ 
-                                  << ") connecting height " << currentHeight << " to " << neighborHeight << "\n";
-                        
-                        placedRamp = true;
-                        break; // Stop after placing one ramp
-                    }
-                }
-            }
+            int currentHeight = surfaceAt(x, z, nullptr);
+            if (currentHeight < 0 || currentHeight + 1 >= height) continue;
+
+            for (const Direction& dir : dirs) {
+                BlockType materialType;
+                if (surfaceAt(x - dir.dx, z - dir.dz, &materialType) != currentHeight + 1) continue;
 
-            // SECOND: Only if no cardinal ramp was placed, try diagonal directions
-            if (!placedRamp) {
-                for (auto& dir : diagonalDirs) {
-                    int neighborX = x + dir.dx;
-                    int neighborZ = z + dir.dz;
-                    
-                    if (neighborX < 0 || neighborX >= width || neighborZ < 0 || neighborZ >= depth)
-                        continue;
-                    
-                    if (rampPlaced[neighborX][neighborZ]) continue;
-                    
-                    int neighborHeight = getTopHeight(neighborX, neighborZ);
-                    if (neighborHeight == -1) continue;
-                    
-                    int heightDiff = currentHeight - neighborHeight;
-                    
-                    if (heightDiff == 1) {
-                        if (isAir(neighborX, neighborHeight + 1, neighborZ)) {
-                            size_t currentIdx = x + width * (currentHeight + height * z);
-                            BlockType materialType = blocks[currentIdx].type;
-                            
-                            size_t rampIdx = neighborX + width * ((neighborHeight + 1) + height * neighborZ);
-                            blocks[rampIdx].type = materialType;
-                            blocks[rampIdx].ramp = dir.rampDir;
-                            rampPlaced[neighborX][neighborZ] = true;
-                            
-                            std::cout << "Placed " << dir.name << " ramp at (" 
-                                      << neighborX << ", " << (neighborHeight + 1) << ", " << neighborZ 
-                                      << ") connecting height " << currentHeight << " to " << neighborHeight << "\n";
-                            
-                            break; // Stop after placing one ramp
-                        }
-                    }
-                }
+                setBlock(x, currentHeight + 1, z, Block{materialType, dir.rampDir});
+                break; // Stop after placing one ramp
             }
         }
     }
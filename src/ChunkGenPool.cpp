@@ -0,0 +1,192 @@
+#include "ChunkGenPool.h"
+#include <algorithm>
+#include <limits>
+
+ChunkGenPool::ChunkGenPool(ChunkManager& manager_, unsigned threads) : manager(manager_) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    pregenWorkers = threads - 1; // none left free for requests with one thread
+    for (unsigned i = 0; i < threads; ++i) workers.emplace_back(&ChunkGenPool::workerMain, this);
+}
+
+ChunkGenPool::~ChunkGenPool() {
+    stop();
+}
+
+void ChunkGenPool::stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (stopping) return;
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers)
+        if (t.joinable()) t.join();
+
+    // nobody will generate these now; release anyone waiting
+    std::lock_guard<std::mutex> lk(mtx);
+    for (auto& job : queue) job.promise->set_value(nullptr);
+    queue.clear();
+    inFlight.clear();
+}
+
+long ChunkGenPool::priorityOf(const ChunkKey& key) const {
+    if (players.empty()) return 0;
+    long best = std::numeric_limits<long>::max();
+    for (const ChunkKey& p : players) {
+        long dx = key.x - p.x, dz = key.z - p.z;
+        best = std::min(best, dx * dx + dz * dz);
+    }
+    return best;
+}
+
+ChunkHandle ChunkGenPool::request(int chunkX, int chunkZ) {
+    ChunkKey key{chunkX, chunkZ};
+    std::lock_guard<std::mutex> lk(mtx);
+    if (ChunkHandle* h = inFlight.find(key)) return *h;
+
+    auto promise = std::make_shared<std::promise<ChunkRef>>();
+    ChunkHandle handle = promise->get_future().share();
+    if (ChunkRef ready = manager.getChunk(chunkX, chunkZ)) {
+        if (size_t* bytes = pregenerated.find(key)) {
+            ++pregenStats.hits;
+            pregenStats.unclaimedBytes -= *bytes;
+            pregenerated.erase(key);
+        }
+        promise->set_value(std::move(ready));
+        return handle;
+    }
+    // already being pregenerated: the job below waits for that to finish
+    if (bool* claimed = pregenActive.find(key)) {
+        if (!*claimed) ++pregenStats.early;
+        *claimed = true;
+    }
+    if (stopping) {
+        promise->set_value(nullptr);
+        return handle;
+    }
+
+    queue.push_back(Job{key, priorityOf(key), nextSeq++, std::move(promise)});
+    std::push_heap(queue.begin(), queue.end(), JobLater());
+    inFlight.emplace(key, handle);
+    wake.notify_one();
+    return handle;
+}
+
+void ChunkGenPool::setPlayerChunks(const std::vector<ChunkKey>& newPlayers) {
+    std::lock_guard<std::mutex> lk(mtx);
+    players = newPlayers;
+    for (auto& job : queue) job.priority = priorityOf(job.key);
+    std::make_heap(queue.begin(), queue.end(), JobLater());
+}
+
+void ChunkGenPool::setPregenTargets(std::vector<ChunkKey> targets) {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        pregenTargets = std::move(targets);
+        pregenNext = 0;
+    }
+    wake.notify_all();
+}
+
+void ChunkGenPool::setPregenMemoryCap(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        pregenCap = bytes;
+        evictPregenerated();
+    }
+    wake.notify_all();
+}
+
+ChunkGenPool::PregenStats ChunkGenPool::getPregenStats() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return pregenStats;
+}
+
+bool ChunkGenPool::nextPregen(ChunkKey& key) {
+    if (pregenRunning >= pregenWorkers || pregenStats.unclaimedBytes >= pregenCap) return false;
+    while (pregenNext < pregenTargets.size()) {
+        key = pregenTargets[pregenNext++];
+        if (inFlight.contains(key) || pregenActive.contains(key) || manager.getChunk(key.x, key.z)) continue;
+        return true;
+    }
+    return false;
+}
+
+void ChunkGenPool::pregenerate(const ChunkKey& key) {
+    manager.loadChunk(key.x, key.z);
+    ChunkRef ref = manager.getChunk(key.x, key.z);
+    size_t bytes = ref ? ref->getMemoryUsage() : 0;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        --pregenRunning;
+        ++pregenStats.generated;
+        bool claimed = *pregenActive.find(key);
+        pregenActive.erase(key);
+        // a request that arrived meanwhile already owns it
+        if (ref && !claimed) {
+            pregenerated.emplace(key, bytes);
+            pregenStats.unclaimedBytes += bytes;
+            evictPregenerated();
+        }
+    }
+    wake.notify_one(); // another worker may pregenerate now
+}
+
+void ChunkGenPool::evictPregenerated() {
+    while (pregenStats.unclaimedBytes > pregenCap && !pregenerated.empty()) {
+        const ChunkKey* furthest = nullptr;
+        long furthestPriority = -1;
+        for (const auto& kv : pregenerated) {
+            long p = priorityOf(kv.first);
+            if (p > furthestPriority) {
+                furthest = &kv.first;
+                furthestPriority = p;
+            }
+        }
+        ChunkKey key = *furthest;
+        // request() checks the manager under mtx too, so it can't see it half gone
+        manager.unloadChunk(key.x, key.z);
+        pregenStats.unclaimedBytes -= *pregenerated.find(key);
+        pregenerated.erase(key);
+        ++pregenStats.evicted;
+    }
+}
+
+size_t ChunkGenPool::getQueuedCount() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return queue.size();
+}
+
+void ChunkGenPool::workerMain() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            ChunkKey pregenKey{0, 0};
+            bool pregen = false;
+            wake.wait(lk, [&] { return stopping || !queue.empty() || (pregen = nextPregen(pregenKey)); });
+            if (stopping) return;
+            if (pregen) { // only reached with no request queued
+                ++pregenRunning;
+                pregenActive.emplace(pregenKey, false);
+                lk.unlock();
+                pregenerate(pregenKey);
+                continue;
+            }
+            std::pop_heap(queue.begin(), queue.end(), JobLater());
+            job = std::move(queue.back());
+            queue.pop_back();
+        }
+
+        // generation takes no pool lock, so other workers and request() run on
+        manager.loadChunk(job.key.x, job.key.z);
+        ChunkRef ref = manager.getChunk(job.key.x, job.key.z);
+
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            inFlight.erase(job.key);
+        }
+        job.promise->set_value(std::move(ref));
+    }
+}
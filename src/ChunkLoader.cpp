@@ -6,7 +6,8 @@
 #include <cmath>
 
 ChunkLoader::ChunkLoader(Client* client_, Player* player_, int chunkSize_, int renderDistance_)
-    : client(client_), player(player_), chunkSize(chunkSize_), renderDistance(renderDistance_), running(false)
+    : client(client_), player(player_), chunkSize(chunkSize_), renderDistance(renderDistance_), running(false),
+      loadedChunks(renderDistance_)
 {
 }
 
@@ -42,20 +43,29 @@ void ChunkLoader::threadMain() {
 
         glm::ivec2 pChunk = playerChunkIndex(*player, chunkSize);
 
+        std::vector<std::pair<ChunkKey, LoadedChunk>> evicted;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            loadedChunks.recenter(pChunk.x, pChunk.y, &evicted);
+        }
+        for (auto &e : evicted) {
+            client->releaseChunk(e.first.x, e.first.z);
+            std::cout << "ChunkLoader: unloaded chunk (" << e.first.x << ", " << e.first.z << ")\n";
+        }
+        evicted.clear(); // meshes are freed outside the lock
+
         for (int dz = -renderDistance; dz <= renderDistance && running; ++dz) {
             for (int dx = -renderDistance; dx <= renderDistance && running; ++dx) {
                 int cx = pChunk.x + dx;
                 int cz = pChunk.y + dz; // ivec2: x,y
 
-                std::pair<int,int> keyPair{cx, cz};
-
                 {
                     // quick check + mark pending
                     std::lock_guard<std::mutex> lock(mtx);
-                    ChunkKey ck{cx, cz};
-                    if (loadedChunks.find(ck) != loadedChunks.end()) continue;
-                    if (pendingRequests.count(keyPair)) continue;
-                    pendingRequests.insert(keyPair);
+                    if (loadedChunks.contains(cx, cz)) continue;
+                    LoadedChunk* slot = loadedChunks.claim(cx, cz);
+                    if (!slot) continue;
+                    slot->pending = true;
                 }
 
                 // do network + mesh build outside lock
@@ -76,44 +86,69 @@ void ChunkLoader::requestAndStoreChunk(int chunkX, int chunkZ) {
     // If your client is not thread-safe, ensure only the loader thread uses it.
     auto chunkData = client->requestChunk((uint32_t)chunkX, 0u, (uint32_t)chunkZ);
 
-    if (chunkData.blocks.empty()) {
+    if (!chunkData.chunk) {
         std::cerr << "ChunkLoader: empty chunk from server for (" << chunkX << "," << chunkZ << ")\n";
         std::lock_guard<std::mutex> lock(mtx);
-        pendingRequests.erase(std::pair<int,int>(chunkX, chunkZ));
+        loadedChunks.release(chunkX, chunkZ);
         return;
     }
 
-    // build mesh (local positions 0..chunkSize-1)
-    auto verts = buildChunkMesh(chunkData.blocks.data(), chunkData.width, chunkData.height, chunkData.depth);
+    ChunkRef chunk = std::move(chunkData.chunk);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        // the player may have moved on while we waited; drop the chunk then
+        LoadedChunk* slot = loadedChunks.get(chunkX, chunkZ);
+        if (!slot || !slot->pending) return;
+        slot->chunk = std::move(chunk);
+        slot->pending = false;
+    }
+
+    // faces of loaded neighbours against this chunk may now be hidden
+    remeshChunk(chunkX, chunkZ);
+    remeshChunk(chunkX - 1, chunkZ);
+    remeshChunk(chunkX + 1, chunkZ);
+    remeshChunk(chunkX, chunkZ - 1);
+    remeshChunk(chunkX, chunkZ + 1);
 
-    // offset into world space (chunk index * chunkSize)
-    glm::vec3 worldOffset((float)chunkX * (float)chunkSize, 0.0f, (float)chunkZ * (float)chunkSize);
-    for (auto &v : verts) v.pos += worldOffset;
+    std::cout << "ChunkLoader: loaded chunk (" << chunkX << ", " << chunkZ << ")\n";
+}
 
+void ChunkLoader::remeshChunk(int chunkX, int chunkZ) {
+    std::shared_ptr<const Chunk> chunk, around[4];
     {
         std::lock_guard<std::mutex> lock(mtx);
-        ChunkKey k{chunkX, chunkZ};
-        loadedChunks.emplace(k, std::move(verts));
-        pendingRequests.erase(std::pair<int,int>(chunkX, chunkZ));
+        const LoadedChunk* slot = loadedChunks.get(chunkX, chunkZ);
+        if (!slot || !slot->chunk) return;
+        chunk = slot->chunk;
+        const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (int i = 0; i < 4; ++i)
+            if (const LoadedChunk* n = loadedChunks.get(chunkX + offsets[i][0], chunkZ + offsets[i][1]))
+                around[i] = n->chunk;
     }
 
-    std::cout << "ChunkLoader: loaded chunk (" << chunkX << ", " << chunkZ << ")\n";
+    // build mesh outside the lock (local positions 0..chunkSize-1, drawn at the chunk's origin)
+    ChunkMesh mesh = buildChunkMesh(*chunk, ChunkNeighbours{around[0].get(), around[1].get(), around[2].get(),
+                                                             around[3].get()});
+
+    std::lock_guard<std::mutex> lock(mtx);
+    // evicted meanwhile: drop the mesh
+    LoadedChunk* slot = loadedChunks.get(chunkX, chunkZ);
+    if (slot && slot->chunk == chunk) slot->mesh = std::move(mesh);
 }
 
-std::vector<Vertex> ChunkLoader::getCombinedMesh() {
-    std::vector<Vertex> combined;
+std::vector<std::pair<ChunkKey, ChunkMesh>> ChunkLoader::getMeshes() {
+    std::vector<std::pair<ChunkKey, ChunkMesh>> meshes;
     std::lock_guard<std::mutex> lock(mtx);
-    // estimate reserve
-    size_t totalVerts = 0;
-    for (auto &kv : loadedChunks) totalVerts += kv.second.size();
-    combined.reserve(totalVerts);
-    for (auto &kv : loadedChunks) {
-        combined.insert(combined.end(), kv.second.begin(), kv.second.end());
-    }
-    return combined; // copy
+    meshes.reserve(loadedChunks.size());
+    loadedChunks.forEach([&](const ChunkKey& key, const LoadedChunk& c) {
+        if (!c.mesh.empty()) meshes.emplace_back(key, c.mesh);
+    });
+    return meshes; // copy
 }
 
 bool ChunkLoader::hasChunks() const {
     std::lock_guard<std::mutex> lock(mtx);
-    return !loadedChunks.empty();
+    bool any = false;
+    loadedChunks.forEach([&](const ChunkKey&, const LoadedChunk& c) { any = any || !c.pending; });
+    return any;
 }
@@ -1,48 +1,147 @@
 #include "ChunkManager.h"
-#include <iostream>
+#include "HeightNoise.h"
 
-ChunkManager::ChunkManager(int chunkSize_, int renderDistance_)
-    : chunkSize(chunkSize_), renderDistance(renderDistance_) {}
+ChunkManager::ChunkManager(int chunkSize_, int renderDistance_, bool hugePages)
+    : chunkPool(std::make_shared<ChunkPool>()), chunkSize(chunkSize_), renderDistance(renderDistance_),
+      pipeline(chunkPool, chunkSize_, CHUNK_HEIGHT) {
+    if (hugePages) BlockBufferPool::instance().setUseHugePages(true);
+}
 
 void ChunkManager::loadChunk(int chunkX, int chunkZ) {
     ChunkKey key{chunkX, chunkZ};
-    std::lock_guard<std::mutex> lk(mtx);
-    if (chunks.find(key) != chunks.end()) return;
-    
-    // Fixed: Use proper height parameter (should be different from width/depth for realistic terrain)
-    auto c = std::make_unique<Chunk>(chunkX, chunkZ, chunkSize, 64, chunkSize); // Using 64 for height
-    c->generateSimpleTerrain();
-    chunks[key] = std::move(c);
-    std::cout << "Server: generated chunk " << chunkX << "," << chunkZ << "\n";
+    Shard& sh = shardFor(key);
+    {
+        std::unique_lock<std::mutex> lk(sh.mtx);
+        if (sh.chunks.contains(key)) {
+            // someone else is generating it: wait for that instead of duplicating work
+            sh.generated.wait(lk, [&] {
+                Slot* cur = sh.chunks.find(key);
+                return !cur || !cur->generating;
+            });
+            return;
+        }
+        sh.chunks[key].generating = true; // placeholder
+    }
+
+    auto c = loadStored(chunkX, chunkZ);
+    bool stored = c != nullptr;
+    if (!stored) c = pipeline.generate(chunkX, chunkZ, worldSeed, caveSampling);
+    ChunkRef ref = chunkPool->publish(std::move(c));
+
+    bool unloaded;
+    {
+        std::lock_guard<std::mutex> lk(sh.mtx);
+        // unloaded while generating: the result is simply dropped
+        Slot* slot = sh.chunks.find(key);
+        unloaded = !slot;
+        if (slot) {
+            slot->chunk = std::move(ref);
+            slot->generating = false;
+        }
+    }
+    // unloadChunk's forget came while the chunk was still requested
+    if (unloaded && !stored) pipeline.forget(chunkX, chunkZ);
+    sh.generated.notify_all();
+}
+
+std::unique_ptr<Chunk> ChunkManager::loadStored(int chunkX, int chunkZ) {
+    std::vector<uint8_t> payload;
+    if (!storage || !storage->load(chunkX, chunkZ, payload)) return nullptr;
+    auto c = chunkPool->acquire(chunkX, chunkZ, chunkSize, CHUNK_HEIGHT, chunkSize);
+    c->deserialize(payload);
+    return c;
 }
 
-Chunk* ChunkManager::getChunk(int chunkX, int chunkZ) {
+ChunkSurface ChunkManager::generateSurface(int chunkX, int chunkZ, int chunks) const {
+    // one batched call for the whole region keeps every SIMD lane busy
+    int side = chunks * chunkSize;
+    std::vector<int> heights((size_t)side * side);
+    HeightNoise::fillHeights(worldSeed, chunkX * chunkSize, chunkZ * chunkSize, side, side, CHUNK_HEIGHT,
+                             heights.data());
+
+    ChunkSurface s;
+    s.height.assign(heights.begin(), heights.end());
+    s.top.assign(heights.size(), Chunk::SURFACE_TYPE);
+    return s;
+}
+
+ChunkRef ChunkManager::getChunk(int chunkX, int chunkZ) {
     ChunkKey key{chunkX, chunkZ};
-    std::lock_guard<std::mutex> lk(mtx);
-    auto it = chunks.find(key);
-    if (it == chunks.end()) return nullptr;
-    return it->second.get();
+    Shard& sh = shardFor(key);
+    std::lock_guard<std::mutex> lk(sh.mtx);
+    Slot* slot = sh.chunks.find(key);
+    if (!slot) return nullptr;
+    return slot->chunk;
+}
+
+bool ChunkManager::setBlock(int worldX, int y, int worldZ, Block b) {
+    int chunkX = floorDiv(worldX);
+    int chunkZ = floorDiv(worldZ);
+    ChunkKey key{chunkX, chunkZ};
+    Shard& sh = shardFor(key);
+    BlockEdit edit{(uint8_t)(worldX - chunkX * chunkSize), (uint8_t)y, (uint8_t)(worldZ - chunkZ * chunkSize), b};
+    const uint32_t voxel = (uint32_t)edit.x | (uint32_t)edit.y << 8 | (uint32_t)edit.z << 16;
+
+    for (;;) {
+        ChunkRef cur;
+        {
+            std::lock_guard<std::mutex> lk(sh.mtx);
+            Slot* slot = sh.chunks.find(key);
+            if (!slot || !slot->chunk) return false;
+            cur = slot->chunk;
+        }
+        if (y < 0 || y >= cur->getHeight()) return false;
+
+        // copy the current version into a pooled chunk and edit it without the
+        // lock, so readers of the shard don't wait on the copy
+        auto next = chunkPool->acquire(chunkX, chunkZ, cur->getWidth(), cur->getHeight(), cur->getDepth());
+        *next = *cur;
+        next->setBlock(edit.x, edit.y, edit.z, b);
+        ChunkRef ref = chunkPool->publish(std::move(next));
+
+        std::lock_guard<std::mutex> lk(sh.mtx);
+        Slot* slot = sh.chunks.find(key);
+        if (!slot || !slot->chunk) return false;
+        // another edit swapped in a newer version meanwhile: redo on that one
+        if (slot->chunk != cur) continue;
+        slot->chunk = std::move(ref);
+
+        auto [it, added] = slot->editIndex.emplace(voxel, (uint32_t)slot->edits.size());
+        if (added) slot->edits.push_back(edit);
+        else slot->edits[it->second] = edit;
+        return true;
+    }
+}
+
+ChunkRef ChunkManager::getChunkWithEdits(int chunkX, int chunkZ, std::vector<BlockEdit>& edits) {
+    ChunkKey key{chunkX, chunkZ};
+    Shard& sh = shardFor(key);
+    std::lock_guard<std::mutex> lk(sh.mtx);
+    Slot* slot = sh.chunks.find(key);
+    edits.clear();
+    if (!slot) return nullptr;
+    edits = slot->edits;
+    return slot->chunk;
 }
 
 void ChunkManager::loadChunkFromData(int chunkX, int chunkZ, int w, int h, int d, const std::vector<uint8_t>& blocks) {
     ChunkKey key{chunkX, chunkZ};
-    std::lock_guard<std::mutex> lk(mtx);
-    if (chunks.find(key) != chunks.end()) return;
-    
-    // Fixed: Use the constructor that takes block data
-    auto c = std::make_unique<Chunk>(chunkX, chunkZ, w, h, d, blocks);
-    chunks[key] = std::move(c);
+    auto c = chunkPool->acquire(chunkX, chunkZ, w, h, d);
+    c->deserialize(blocks);
+    ChunkRef ref = chunkPool->publish(std::move(c));
+
+    Shard& sh = shardFor(key);
+    std::lock_guard<std::mutex> lk(sh.mtx);
+    Slot& slot = sh.chunks[key];
+    if (!slot.chunk && !slot.generating) slot.chunk = std::move(ref);
 }
 
-std::vector<std::pair<ChunkKey, std::shared_ptr<Chunk>>> ChunkManager::getLoadedChunksSnapshot() {
-    std::vector<std::pair<ChunkKey, std::shared_ptr<Chunk>>> out;
-    std::lock_guard<std::mutex> lk(mtx);
-    out.reserve(chunks.size());
-    for (auto &kv : chunks) {
-        // Fixed: Create a proper shared_ptr with custom deleter that does nothing
-        // This allows safe sharing without interfering with the unique_ptr ownership
-        std::shared_ptr<Chunk> sharedChunk(kv.second.get(), [](Chunk*){ /* no-op deleter */ });
-        out.emplace_back(kv.first, sharedChunk);
+std::vector<std::pair<ChunkKey, ChunkRef>> ChunkManager::getLoadedChunksSnapshot() {
+    std::vector<std::pair<ChunkKey, ChunkRef>> out;
+    for (auto &sh : shards) {
+        std::lock_guard<std::mutex> lk(sh.mtx);
+        for (auto &kv : sh.chunks)
+            if (kv.second.chunk) out.emplace_back(kv.first, kv.second.chunk);
     }
     return out;
 }
@@ -50,36 +149,34 @@ std::vector<std::pair<ChunkKey, std::shared_ptr<Chunk>>> ChunkManager::getLoaded
 // Additional helper methods that might be useful:
 
 std::vector<uint8_t> ChunkManager::serializeChunk(int chunkX, int chunkZ) {
-    ChunkKey key{chunkX, chunkZ};
-    std::lock_guard<std::mutex> lk(mtx);
-    auto it = chunks.find(key);
-    if (it == chunks.end()) return {};
-    
-    const auto& blocks = it->second->getBlocks();
-    std::vector<uint8_t> serialized;
-    
-    // Pack Block data: [blockType, isRamp, rampDirection] for each block
-    serialized.reserve(blocks.size() * 3);
-    for (const auto& block : blocks) {
-        serialized.push_back(static_cast<uint8_t>(block.type));
-
-        serialized.push_back(static_cast<uint8_t>(block.ramp));
-    }
-    
-    return serialized;
+    ChunkRef c = getChunk(chunkX, chunkZ);
+    if (!c) return {};
+    return c->serialize();
 }
 
 void ChunkManager::unloadChunk(int chunkX, int chunkZ) {
     ChunkKey key{chunkX, chunkZ};
-    std::lock_guard<std::mutex> lk(mtx);
-    auto it = chunks.find(key);
-    if (it != chunks.end()) {
-        chunks.erase(it);
-        std::cout << "Server: unloaded chunk " << chunkX << "," << chunkZ << "\n";
+    Shard& sh = shardFor(key);
+    ChunkRef dropped;
+    {
+        std::lock_guard<std::mutex> lk(sh.mtx);
+        Slot* slot = sh.chunks.find(key);
+        if (!slot) return;
+        // readers still holding this version keep it alive; the last one
+        // to let go returns it to the pool
+        dropped = std::move(slot->chunk);
+        sh.chunks.erase(key);
     }
+    pipeline.forget(chunkX, chunkZ);
+    sh.generated.notify_all();
 }
 
 size_t ChunkManager::getLoadedChunkCount() {
-    std::lock_guard<std::mutex> lk(mtx);
-    return chunks.size();
+    size_t n = 0;
+    for (auto &sh : shards) {
+        std::lock_guard<std::mutex> lk(sh.mtx);
+        for (auto &kv : sh.chunks)
+            if (kv.second.chunk) ++n;
+    }
+    return n;
 }
@@ -1,6 +1,7 @@
 #include "ChunkMeshBuilder.h"
 #include "Chunk.h"
 #include <Block.h>
+#include <algorithm>
 static std::vector<Vertex> makeCube(glm::ivec3 pos) {
     // positions + UV for a cube
     float raw[] = {
@@ -48,115 +49,442 @@ static std::vector<Vertex> makeCube(glm::ivec3 pos) {
         -0.5f,  0.5f, -0.5f, 0.0f, 1.0f
     };
 
-    const int verts = 36;
+    // each face is two triangles a, b, c and c, d, a; keep its corners a, b, c, d
+    const int corners[4] = {0, 1, 2, 4};
     std::vector<Vertex> cube;
-    cube.reserve(verts);
-    for (int i = 0; i < verts; ++i) {
-        Vertex v;
-        v.pos = glm::vec3(raw[i * 5 + 0], raw[i * 5 + 1], raw[i * 5 + 2]) + glm::vec3(pos);
-        v.tex = glm::vec2(raw[i * 5 + 3], raw[i * 5 + 4]);
-        cube.push_back(v);
+    cube.reserve(24);
+    for (int f = 0; f < 6; ++f) {
+        for (int c : corners) {
+            int i = f * 6 + c;
+            cube.push_back(Vertex::pack(glm::vec3(raw[i * 5 + 0], raw[i * 5 + 1], raw[i * 5 + 2]) + glm::vec3(pos),
+                                        glm::vec2(raw[i * 5 + 3], raw[i * 5 + 4]), 0));
+        }
     }
     return cube;
 }
 
+// four corners per face, in face order
 static std::vector<Vertex> cubeVertexTemplate = makeCube(glm::ivec3(0,0,0));
 
-std::vector<Vertex> buildChunkMesh(const unsigned char* data, int width, int height, int depth) {
-    std::vector<Vertex> verts;
+namespace {
+
+// What a voxel hides of the faces touching it: nothing, all six, or for a
+// ramp (OCC_RAMP + its RampDirection) the sides its shape fills completely
+constexpr uint8_t OCC_AIR = 0, OCC_SOLID = 1, OCC_RAMP = 2;
+
+// Faces of cubeVertexTemplate in order, and the neighbour each looks at
+constexpr int FACE_NEG_Z = 0, FACE_POS_Z = 1, FACE_NEG_X = 2, FACE_POS_X = 3, FACE_NEG_Y = 4, FACE_POS_Y = 5;
+constexpr int FACE_DX[6] = {0, 0, -1, 1, 0, 0};
+constexpr int FACE_DY[6] = {0, 0, 0, 0, -1, 1};
+constexpr int FACE_DZ[6] = {-1, 1, 0, 0, 0, 0};
+
+// Per face, the axis (0 = x, 1 = y, 2 = z) it faces along and the axes its
+// texture u and v run along in cubeVertexTemplate
+constexpr int FACE_AXIS[6] = {2, 2, 0, 0, 1, 1};
+constexpr int FACE_U[6] = {0, 0, 1, 1, 0, 0};
+constexpr int FACE_V[6] = {1, 1, 2, 2, 2, 2};
 
-    auto index = [width, height](int x, int y, int z) {
-        return x + width * (y + height * z);
+uint8_t occupancy(BlockType type, RampDirection ramp) {
+    if (type == BlockType::Air) return OCC_AIR;
+    return ramp == RampDirection::None ? OCC_SOLID : (uint8_t)(OCC_RAMP + (uint8_t)ramp);
+}
+
+// Whether a voxel of class occ fills its whole side facing face f of the
+// cube next to it. Every ramp has a full bottom, and straight ramps a full
+// wall at their high end; the sloped and triangular sides hide nothing.
+bool coversFace(uint8_t occ, int f) {
+    if (occ == OCC_SOLID) return true;
+    if (occ < OCC_RAMP) return false;
+    if (f == FACE_POS_Y) return true; // the ramp's bottom
+    switch ((RampDirection)(occ - OCC_RAMP)) {
+    case RampDirection::North: return f == FACE_NEG_Z; // wall at +z
+    case RampDirection::South: return f == FACE_POS_Z; // wall at -z
+    case RampDirection::East: return f == FACE_POS_X;  // wall at -x
+    case RampDirection::West: return f == FACE_NEG_X;  // wall at +x
+    default: return false;
+    }
+}
+
+// Face f of the box of blocks from lo spanning size (1 along FACE_AXIS[f]):
+// the template face stretched over it, with uv counting blocks so the
+// texture repeats once per block
+void addMergedFace(int f, BlockType type, const int lo[3], const int size[3], ChunkMesh& mesh) {
+    const int tile = getTileIndexForBlock(type);
+    for (int i = f * 4; i < f * 4 + 4; ++i) {
+        glm::vec3 pos = cubeVertexTemplate[i].getPosition();
+        glm::vec2 uv = cubeVertexTemplate[i].getTexCoord();
+        for (int k = 0; k < 3; ++k) pos[k] += (float)lo[k] + (pos[k] > 0.0f ? (float)(size[k] - 1) : 0.0f);
+        uv.x *= (float)size[FACE_U[f]];
+        uv.y *= (float)size[FACE_V[f]];
+        mesh.quads.push_back(Vertex::pack(pos, uv, tile));
+    }
+}
+
+// Every column's blocks as 64-bit masks, bit y for layer y. A cube's top
+// face shows where the column shifted down by one has no block, its bottom
+// where the column shifted up has no cube (below the world is solid), and
+// its sides where the neighbouring column's cover mask for that side is
+// clear. Each test handles the whole column at once; only the visible faces
+// are then visited, lowest bit first.
+void addBitmaskFaces(const Chunk& chunk, const ChunkNeighbours& neighbours, ChunkMesh& mesh) {
+    const int width = chunk.getWidth();
+    const int depth = chunk.getDepth();
+    const size_t columns = (size_t)width * depth;
+
+    std::vector<uint64_t> types(columns * BLOCK_TYPE_COUNT);
+    chunk.getTypeColumns(types.data());
+    std::vector<uint64_t> ramp(columns, 0);
+    for (const RampEntry& r : chunk.getRamps()) ramp[r.x + (size_t)width * r.z] |= 1ull << r.y;
+
+    // Per side face f (-z, +z, -x, +x), the voxels of each column that hide
+    // face f of the cube beside them: cubes, and ramps with a full wall
+    // there. Padded by one column, filled from the neighbours where loaded.
+    const int gw = width + 2, gd = depth + 2;
+    std::vector<uint64_t> cover((size_t)4 * gw * gd, 0);
+    auto coverAt = [&](int f, int x, int z) -> uint64_t& {
+        return cover[(size_t)f * gw * gd + (size_t)(x + 1) + (size_t)gw * (z + 1)];
+    };
+    auto setColumn = [&](int x, int z, uint64_t blocks) {
+        for (int f = 0; f < 4; ++f) coverAt(f, x, z) = blocks;
+    };
+    auto setRamp = [&](int x, int z, const RampEntry& r) {
+        const uint64_t bit = 1ull << r.y;
+        for (int f = 0; f < 4; ++f) {
+            if (coversFace((uint8_t)(OCC_RAMP + (uint8_t)r.dir), f)) coverAt(f, x, z) |= bit;
+            else coverAt(f, x, z) &= ~bit;
+        }
     };
+    for (int z = 0; z < depth; ++z)
+        for (int x = 0; x < width; ++x) setColumn(x, z, chunk.getSolidColumn(x, z));
+    for (const RampEntry& r : chunk.getRamps()) setRamp(r.x, r.z, r);
+
+    // neighbours have the same shape; (nx, nz) is the column in n next to (x, z)
+    if (const Chunk* n = neighbours.negX) {
+        for (int z = 0; z < depth; ++z) setColumn(-1, z, n->getSolidColumn(width - 1, z));
+        for (const RampEntry& r : n->getRamps())
+            if (r.x == width - 1) setRamp(-1, r.z, r);
+    }
+    if (const Chunk* n = neighbours.posX) {
+        for (int z = 0; z < depth; ++z) setColumn(width, z, n->getSolidColumn(0, z));
+        for (const RampEntry& r : n->getRamps())
+            if (r.x == 0) setRamp(width, r.z, r);
+    }
+    if (const Chunk* n = neighbours.negZ) {
+        for (int x = 0; x < width; ++x) setColumn(x, -1, n->getSolidColumn(x, depth - 1));
+        for (const RampEntry& r : n->getRamps())
+            if (r.z == depth - 1) setRamp(r.x, -1, r);
+    }
+    if (const Chunk* n = neighbours.posZ) {
+        for (int x = 0; x < width; ++x) setColumn(x, depth, n->getSolidColumn(x, 0));
+        for (const RampEntry& r : n->getRamps())
+            if (r.z == 0) setRamp(r.x, depth, r);
+    }
 
-    for (int x = 0; x < width; ++x) {
-        for (int z = 0; z < depth; ++z) {
-            for (int y = 0; y < height; ++y) {
-                int blockIndex = index(x, y, z);
-                
-                // Data is now packed as: [blockType, rampDirection, blockType, rampDirection, ...]
-                // So each block takes 2 bytes
-                const unsigned char rawBlockType = data[blockIndex * 2];
-                const unsigned char rawRampDir = data[blockIndex * 2 + 1];
-
-                // Convert raw bytes back to Block struct
-                Block block;
-                block.type = static_cast<BlockType>(rawBlockType);
-                block.ramp = static_cast<RampDirection>(rawRampDir);
-
-                if (block.type == BlockType::Air) continue;
-
-                glm::vec3 pos = glm::vec3(x, y, z);
-
-                if (block.ramp != RampDirection::None) {
-                    addRampMesh(block.ramp, block.type, pos, verts);
-                } else {
-                    addCubeMesh(block.type, pos, verts);
+    // visible faces per column, counted first so the mesh grows only once
+    std::vector<uint64_t> visible(columns * 6, 0);
+    size_t faces = 0;
+    for (int z = 0; z < depth; ++z)
+        for (int x = 0; x < width; ++x) {
+            const size_t c = x + (size_t)width * z;
+            const uint64_t solid = chunk.getSolidColumn(x, z);
+            const uint64_t cubes = solid & ~ramp[c];
+            if (!cubes) continue;
+            uint64_t* v = &visible[c * 6];
+            v[FACE_NEG_Z] = cubes & ~coverAt(FACE_NEG_Z, x, z - 1);
+            v[FACE_POS_Z] = cubes & ~coverAt(FACE_POS_Z, x, z + 1);
+            v[FACE_NEG_X] = cubes & ~coverAt(FACE_NEG_X, x - 1, z);
+            v[FACE_POS_X] = cubes & ~coverAt(FACE_POS_X, x + 1, z);
+            v[FACE_NEG_Y] = cubes & ~((cubes << 1) | 1);
+            v[FACE_POS_Y] = cubes & ~(solid >> 1);
+            for (int f = 0; f < 6; ++f) faces += (size_t)__builtin_popcountll(v[f]);
+        }
+    // ramp shapes take at most three quads and four triangles
+    mesh.quads.reserve(mesh.quads.size() + (faces + chunk.getRamps().size() * 3) * 4);
+    mesh.triangles.reserve(mesh.triangles.size() + chunk.getRamps().size() * 12);
+
+    uint32_t tiles[BLOCK_TYPE_COUNT];
+    for (int t = 0; t < BLOCK_TYPE_COUNT; ++t) tiles[t] = (uint32_t)getTileIndexForBlock((BlockType)t) << 24;
+    // the faces of cubeVertexTemplate, on the stack so the loop below keeps them in registers
+    Vertex face[6][4];
+    std::copy(cubeVertexTemplate.begin(), cubeVertexTemplate.end(), &face[0][0]);
+
+    // The counted faces are written straight into the grown buffer. Within a
+    // column, type and face only y changes from quad to quad, so the
+    // corners are made once and each bit adds just its height.
+    const size_t first = mesh.quads.size();
+    mesh.quads.resize(first + faces * 4);
+    Vertex* out = mesh.quads.data() + first;
+    for (int z = 0; z < depth; ++z)
+        for (int x = 0; x < width; ++x) {
+            const size_t c = x + (size_t)width * z;
+            const uint64_t* v = &visible[c * 6];
+            if (!(v[0] | v[1] | v[2] | v[3] | v[4] | v[5])) continue;
+            const uint32_t column = Vertex::blockOffset(x, 0, z);
+            for (int t = 1; t < BLOCK_TYPE_COUNT; ++t) {
+                const uint64_t ofType = types[(size_t)t * columns + c];
+                if (!ofType) continue;
+                for (int f = 0; f < 6; ++f) {
+                    uint64_t bits = v[f] & ofType;
+                    if (!bits) continue;
+                    Vertex corner[4];
+                    for (int k = 0; k < 4; ++k) corner[k] = Vertex{face[f][k].pos + column, face[f][k].tex | tiles[t]};
+                    for (; bits; bits &= bits - 1) {
+                        const uint32_t y = Vertex::blockOffset(0, __builtin_ctzll(bits), 0);
+                        for (int k = 0; k < 4; ++k) out[k] = Vertex{corner[k].pos + y, corner[k].tex};
+                        out += 4;
+                    }
                 }
             }
         }
+}
+
+} // namespace
+
+ChunkMesh buildChunkMesh(const Chunk& chunk, const ChunkNeighbours& neighbours, MeshMode mode) {
+    ChunkMesh mesh;
+
+    const int width = chunk.getWidth();
+    const int height = chunk.getHeight();
+    const int depth = chunk.getDepth();
+    const bool hasRamps = !chunk.getRamps().empty();
+
+    // nothing above the highest or below the lowest solid block produces geometry
+    if (chunk.getMaxSolidY() < 0) return mesh;
+    const int yMin = chunk.getMinSolidY();
+    const int yMax = std::min(chunk.getMaxSolidY() + 1, height);
+
+    if (mode == MeshMode::Bitmask && height <= 64) {
+        addBitmaskFaces(chunk, neighbours, mesh);
+        for (const RampEntry& r : chunk.getRamps())
+            addRampMesh(r.dir, chunk.getBlockType(r.x, r.y, r.z), glm::vec3(r.x, r.y, r.z), mesh);
+        return mesh;
+    }
+
+    // Occupancy of the solid range plus a one-voxel border: the layers just
+    // above and below, and the edge columns of the neighbouring chunks. Below
+    // the world counts as solid; a missing neighbour as air, so its border
+    // faces stay until the chunk is remeshed with it.
+    const int gw = width + 2, gd = depth + 2, gh = yMax - yMin + 2;
+    std::vector<uint8_t> occ((size_t)gw * gd * gh, OCC_AIR);
+    auto at = [&](int x, int y, int z) -> uint8_t& {
+        return occ[(size_t)(x + 1) + (size_t)gw * ((z + 1) + (size_t)gd * (y - yMin + 1))];
+    };
+    if (yMin == 0)
+        for (int z = -1; z <= depth; ++z)
+            for (int x = -1; x <= width; ++x) at(x, -1, z) = OCC_SOLID;
+
+    for (int s = yMin / Chunk::SECTION_HEIGHT; s * Chunk::SECTION_HEIGHT < yMax; ++s) {
+        if (chunk.getSection(s).isEmpty()) continue;
+        chunk.forEachInSection(s, [&](int x, int y, int z, BlockType type) {
+            if (y >= yMin && y < yMax && type != BlockType::Air) at(x, y, z) = OCC_SOLID;
+        });
+    }
+    for (const RampEntry& r : chunk.getRamps()) at(r.x, r.y, r.z) = (uint8_t)(OCC_RAMP + (uint8_t)r.dir);
+
+    // neighbours have the same shape; (nx, nz) is the column in n next to (x, z)
+    auto border = [&](const Chunk* n, int nx, int nz, int x, int z) {
+        if (!n) return;
+        for (int y = yMin; y < yMax; ++y) at(x, y, z) = occupancy(n->getBlockType(nx, y, nz), n->getRamp(nx, y, nz));
+    };
+    for (int z = 0; z < depth; ++z) {
+        border(neighbours.negX, width - 1, z, -1, z);
+        border(neighbours.posX, 0, z, width, z);
+    }
+    for (int x = 0; x < width; ++x) {
+        border(neighbours.negZ, x, depth - 1, x, -1);
+        border(neighbours.posZ, x, 0, x, depth);
+    }
+
+    if (mode != MeshMode::Greedy) {
+        for (int s = yMin / Chunk::SECTION_HEIGHT; s * Chunk::SECTION_HEIGHT < yMax; ++s) {
+            // all-air sections produce no geometry
+            if (chunk.getSection(s).isEmpty()) continue;
+
+            // walk the section in storage order
+            chunk.forEachInSection(s, [&](int x, int y, int z, BlockType type) {
+                if (type == BlockType::Air || y < yMin || y >= yMax) return;
+                // ramp voxels are emitted from the overlay below
+                if (hasRamps && at(x, y, z) != OCC_SOLID) return;
+
+                uint8_t faces = 0;
+                for (int f = 0; f < 6; ++f)
+                    if (!coversFace(at(x + FACE_DX[f], y + FACE_DY[f], z + FACE_DZ[f]), f))
+                        faces |= (uint8_t)(1 << f);
+                if (faces) addCubeMesh(type, glm::vec3(x, y, z), mesh, faces);
+            });
+        }
+    } else {
+        // cube types of the solid range; air where there is none or a ramp
+        const int dims[3] = {width, yMax - yMin, depth};
+        std::vector<BlockType> types((size_t)width * depth * dims[1], BlockType::Air);
+        auto typeAt = [&](int x, int y, int z) -> BlockType& {
+            return types[(size_t)x + (size_t)width * (z + (size_t)depth * (y - yMin))];
+        };
+        for (int s = yMin / Chunk::SECTION_HEIGHT; s * Chunk::SECTION_HEIGHT < yMax; ++s) {
+            if (chunk.getSection(s).isEmpty()) continue;
+            chunk.forEachInSection(s, [&](int x, int y, int z, BlockType type) {
+                if (y >= yMin && y < yMax) typeAt(x, y, z) = type;
+            });
+        }
+        for (const RampEntry& r : chunk.getRamps()) typeAt(r.x, r.y, r.z) = BlockType::Air;
+
+        // Per face direction and slice across it, mark the blocks showing that
+        // face, then cover the marks with rectangles: run along u as far as
+        // the type holds, then extend the run along v while whole rows match.
+        std::vector<BlockType> mask;
+        for (int f = 0; f < 6; ++f) {
+            const int n = FACE_AXIS[f], u = FACE_U[f], v = FACE_V[f];
+            const int du = dims[u], dv = dims[v];
+            mask.assign((size_t)du * dv, BlockType::Air);
+            for (int slice = 0; slice < dims[n]; ++slice) {
+                int c[3];
+                c[n] = slice;
+                bool any = false;
+                for (c[v] = 0; c[v] < dv; ++c[v])
+                    for (c[u] = 0; c[u] < du; ++c[u]) {
+                        const int x = c[0], y = c[1] + yMin, z = c[2];
+                        BlockType t = typeAt(x, y, z);
+                        if (t == BlockType::Air ||
+                            coversFace(at(x + FACE_DX[f], y + FACE_DY[f], z + FACE_DZ[f]), f))
+                            continue;
+                        mask[(size_t)c[u] + (size_t)du * c[v]] = t;
+                        any = true;
+                    }
+                if (!any) continue;
+
+                for (int cv = 0; cv < dv; ++cv)
+                    for (int cu = 0; cu < du;) {
+                        BlockType* row = &mask[(size_t)du * cv];
+                        const BlockType t = row[cu];
+                        if (t == BlockType::Air) {
+                            ++cu;
+                            continue;
+                        }
+                        int w = 1;
+                        while (cu + w < du && row[cu + w] == t) ++w;
+                        int h = 1;
+                        for (; cv + h < dv; ++h) {
+                            const BlockType* next = row + (size_t)du * h;
+                            if (std::any_of(next + cu, next + cu + w, [t](BlockType b) { return b != t; })) break;
+                        }
+                        for (int k = 0; k < h; ++k) std::fill_n(row + (size_t)du * k + cu, w, BlockType::Air);
+
+                        int lo[3], size[3];
+                        lo[n] = slice;
+                        lo[u] = cu;
+                        lo[v] = cv;
+                        lo[1] += yMin;
+                        size[n] = 1;
+                        size[u] = w;
+                        size[v] = h;
+                        addMergedFace(f, t, lo, size, mesh);
+                        cu += w;
+                    }
+            }
+        }
     }
 
-    return verts;
+    for (const RampEntry& r : chunk.getRamps()) {
+        addRampMesh(r.dir, chunk.getBlockType(r.x, r.y, r.z), glm::vec3(r.x, r.y, r.z), mesh);
+    }
+
+    return mesh;
 }
 
 
-void addCubeMesh(BlockType type, glm::vec3 pos, std::vector<Vertex>& verts) {
+void addCubeMesh(BlockType type, glm::vec3 pos, ChunkMesh& mesh, uint8_t faces) {
     // Generate cube vertices at pos
     // Set texture coordinates based on block type
-    glm::vec2 texCoord = getTextureCoordForBlock(type);
-
-    // Cube vertices (simplified)
-    // You need your cube vertex positions & UVs here
-    for (auto& vert : cubeVertexTemplate) {
-        Vertex v = vert;
-        v.pos += pos;
-        v.tex += texCoord;
-        verts.push_back(v);
+    const uint32_t offset = Vertex::blockOffset((int)pos.x, (int)pos.y, (int)pos.z);
+    const uint32_t tile = (uint32_t)getTileIndexForBlock(type) << 24;
+
+    // four corners per face, in the order of the face bits
+    for (int f = 0; f < 6; ++f) {
+        if (!(faces & (1 << f))) continue;
+        for (int i = f * 4; i < f * 4 + 4; ++i) {
+            Vertex v = cubeVertexTemplate[i];
+            v.pos += offset;
+            v.tex |= tile;
+            mesh.quads.push_back(v);
+        }
     }
 }
 
 
 
-void addRampMesh(RampDirection dir, BlockType type, glm::vec3 pos, std::vector<Vertex>& verts) {
-    glm::vec2 texCoord = getTextureCoordForBlock(type);
+// Triangles from x, y, z, u, v rows. Pairs written a, b, c, c, d, a become
+// the quad a, b, c, d; the rest stay triangles.
+static void addRampVertices(const float* raw, int numVerts, glm::vec3 pos, int tile, ChunkMesh& mesh) {
+    auto vertex = [&](int i) {
+        return Vertex::pack(glm::vec3(raw[i*5+0], raw[i*5+1], raw[i*5+2]) + pos, glm::vec2(raw[i*5+3], raw[i*5+4]),
+                            tile);
+    };
+    auto same = [&](int a, int b) { return std::equal(raw + a * 5, raw + a * 5 + 5, raw + b * 5); };
+    for (int i = 0; i + 3 <= numVerts;) {
+        if (i + 6 <= numVerts && same(i + 2, i + 3) && same(i, i + 5)) {
+            for (int c : {i, i + 1, i + 2, i + 4}) mesh.quads.push_back(vertex(c));
+            i += 6;
+        } else {
+            for (int c = i; c < i + 3; ++c) mesh.triangles.push_back(vertex(c));
+            i += 3;
+        }
+    }
+}
 
+// The shape of a ramp facing dir; addRampMesh packs each at the origin once
+static void addRampShape(RampDirection dir, glm::vec3 pos, int tile, ChunkMesh& mesh) {
     switch (dir) {
         case RampDirection::North:
-            addVerticesForRampNorth(pos, texCoord, verts);
+            addVerticesForRampNorth(pos, tile, mesh);
             break;
         case RampDirection::South:
-            addVerticesForRampSouth(pos, texCoord, verts);
+            addVerticesForRampSouth(pos, tile, mesh);
             break;
         case RampDirection::East:
-            addVerticesForRampEast(pos, texCoord, verts);
+            addVerticesForRampEast(pos, tile, mesh);
             break;
         case RampDirection::West:
-            addVerticesForRampWest(pos, texCoord, verts);
+            addVerticesForRampWest(pos, tile, mesh);
             break;
         case RampDirection::NorthEast:
-            addVerticesForRampNorthEast(pos, texCoord, verts);
+            addVerticesForRampNorthEast(pos, tile, mesh);
             break;
         case RampDirection::NorthWest:
-            addVerticesForRampNorthWest(pos, texCoord, verts);
+            addVerticesForRampNorthWest(pos, tile, mesh);
             break;
         case RampDirection::SouthEast:
-            addVerticesForRampSouthEast(pos, texCoord, verts);
+            addVerticesForRampSouthEast(pos, tile, mesh);
             break;
         case RampDirection::SouthWest:
-            addVerticesForRampSouthWest(pos, texCoord, verts);
+            addVerticesForRampSouthWest(pos, tile, mesh);
             break;
         default:
             break;
     }
 }
 
+void addRampMesh(RampDirection dir, BlockType type, glm::vec3 pos, ChunkMesh& mesh) {
+    // every ramp of a direction is the same shape, so pack each once and move
+    // it by whole blocks like the cube faces
+    static const std::vector<ChunkMesh> shapes = [] {
+        std::vector<ChunkMesh> all((size_t)RampDirection::SouthWest + 1);
+        for (size_t d = 0; d < all.size(); ++d) addRampShape((RampDirection)d, glm::vec3(0.0f), 0, all[d]);
+        return all;
+    }();
+    if ((size_t)dir >= shapes.size()) return;
+    const ChunkMesh& shape = shapes[(size_t)dir];
+    const uint32_t offset = Vertex::blockOffset((int)pos.x, (int)pos.y, (int)pos.z);
+    const uint32_t tile = (uint32_t)getTileIndexForBlock(type) << 24;
+    for (const Vertex& v : shape.quads) mesh.quads.push_back(Vertex{v.pos + offset, v.tex | tile});
+    for (const Vertex& v : shape.triangles) mesh.triangles.push_back(Vertex{v.pos + offset, v.tex | tile});
+}
+
 
 
 
 
 
-void addVerticesForRampNorth(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampNorth(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // North-facing ramp: high at Z=+0.5, low at Z=-0.5
     float vertices[] = {
         // Bottom face (flat)
@@ -198,15 +526,10 @@ void addVerticesForRampNorth(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vert
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
-void addVerticesForRampSouth(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampSouth(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // South-facing ramp: high at Z=-0.5, low at Z=+0.5
     float vertices[] = {
         // Bottom face (flat)
@@ -248,15 +571,10 @@ void addVerticesForRampSouth(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vert
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
-void addVerticesForRampEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampEast(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // East-facing ramp: high at X=-0.5, low at X=+0.5
     float vertices[] = {
         // Bottom face (flat)
@@ -298,15 +616,10 @@ void addVerticesForRampEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Verte
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
-void addVerticesForRampWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampWest(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // West-facing ramp: high at X=+0.5, low at X=-0.5
     float vertices[] = {
         // Bottom face (flat)
@@ -348,18 +661,13 @@ void addVerticesForRampWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Verte
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
 
 
 
-void addVerticesForRampNorthEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampNorthEast(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // Corner ramp: high at (-0.5, -0.5), low at (+0.5, +0.5)
     float vertices[] = {
         // Bottom face (flat)
@@ -402,15 +710,10 @@ void addVerticesForRampNorthEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
-void addVerticesForRampNorthWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampNorthWest(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // Corner ramp: high at (+0.5, -0.5), low at (-0.5, +0.5)
     float vertices[] = {
         // Bottom face (flat)
@@ -443,15 +746,10 @@ void addVerticesForRampNorthWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
-void addVerticesForRampSouthEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampSouthEast(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // Corner ramp: high at (-0.5, +0.5), low at (+0.5, -0.5)
     float vertices[] = {
         // Bottom face (flat)
@@ -484,15 +782,10 @@ void addVerticesForRampSouthEast(glm::vec3 pos, glm::vec2 texCoord, std::vector<
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
-void addVerticesForRampSouthWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<Vertex>& verts) {
+void addVerticesForRampSouthWest(glm::vec3 pos, int tile, ChunkMesh& mesh) {
     // Corner ramp: high at (+0.5, +0.5), low at (-0.5, -0.5)  
     float vertices[] = {
         // Bottom face (flat)
@@ -525,12 +818,7 @@ void addVerticesForRampSouthWest(glm::vec3 pos, glm::vec2 texCoord, std::vector<
     };
     
     int numVerts = sizeof(vertices) / (5 * sizeof(float));
-    for (int i = 0; i < numVerts; i++) {
-        Vertex v;
-        v.pos = glm::vec3(vertices[i*5+0], vertices[i*5+1], vertices[i*5+2]) + pos;
-        v.tex = glm::vec2(vertices[i*5+3], vertices[i*5+4]) + texCoord;
-        verts.push_back(v);
-    }
+    addRampVertices(vertices, numVerts, pos, tile, mesh);
 }
 
 
@@ -0,0 +1,142 @@
+#include "ChunkPipeline.h"
+#include "HeightNoise.h"
+#include <chrono>
+
+ChunkPipeline::ChunkPipeline(std::shared_ptr<ChunkPool> pool_, int chunkSize_, int chunkHeight_)
+    : pool(std::move(pool_)), chunkSize(chunkSize_), chunkHeight(chunkHeight_) {}
+
+ChunkPipeline::~ChunkPipeline() {
+    for (auto& kv : protos) pool->release(std::move(kv.second.chunk));
+}
+
+std::unique_ptr<Chunk> ChunkPipeline::generate(int chunkX, int chunkZ, int32_t worldSeed,
+                                               CaveField::Sampling caves) {
+    ChunkKey key{chunkX, chunkZ};
+    std::unique_lock<std::mutex> lk(mtx);
+    // completed before and handed out since: only the surface is left, start over
+    if (Proto* p = protos.find(key); p && p->stage == GenStage::Ramps) protos.erase(key);
+    // keeps the chunk and the neighbours it advances from being dropped meanwhile
+    protos[key].requested = true;
+
+    for (;;) {
+        Task task;
+        Next n = next(key, GenStage::Ramps, task);
+        if (n == Next::Done) break;
+        if (n == Next::Blocked) advanced.wait(lk);
+        else run(lk, task, worldSeed, caves);
+    }
+    Proto& p = *protos.find(key);
+    p.requested = false;
+    p.handedOut = true;
+    return std::move(p.chunk);
+}
+
+ChunkPipeline::Next ChunkPipeline::next(const ChunkKey& key, GenStage want, Task& out) {
+    // no reference into protos survives the recursion: inserts move entries
+    GenStage have, stage;
+    bool blocked;
+    {
+        Proto& p = protos[key];
+        if (p.stage >= want) return Next::Done;
+        have = p.stage;
+        stage = (GenStage)((int)have + 1);
+        blocked = p.busy;
+    }
+
+    int r = genStageRadius(stage);
+    for (int dz = -r; dz <= r; ++dz)
+        for (int dx = -r; dx <= r; ++dx) {
+            if (dx == 0 && dz == 0) continue;
+            Next n = next(ChunkKey{key.x + dx, key.z + dz}, have, out);
+            if (n == Next::Run) return n;
+            blocked = blocked || n == Next::Blocked;
+        }
+    if (blocked) return Next::Blocked;
+    out = Task{key, stage};
+    return Next::Run;
+}
+
+void ChunkPipeline::run(std::unique_lock<std::mutex>& lk, const Task& task, int32_t worldSeed,
+                        CaveField::Sampling caves) {
+    // check the proto's data out so the stage can run without the lock
+    Proto& p = *protos.find(task.key);
+    p.busy = true;
+    std::unique_ptr<Chunk> chunk = std::move(p.chunk);
+    std::vector<int> columnHeight = std::move(p.columnHeight);
+    std::shared_ptr<const ChunkSurface> around[9];
+    if (genStageRadius(task.stage) > 0)
+        for (int dz = -1; dz <= 1; ++dz)
+            for (int dx = -1; dx <= 1; ++dx)
+                around[(dx + 1) + 3 * (dz + 1)] = protos.find(ChunkKey{task.key.x + dx, task.key.z + dz})->surface;
+    lk.unlock();
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::shared_ptr<const ChunkSurface> surface;
+    switch (task.stage) {
+    case GenStage::Heightmap:
+        chunk = pool->acquire(task.key.x, task.key.z, chunkSize, chunkHeight, chunkSize);
+        columnHeight.resize((size_t)chunkSize * chunkSize);
+        HeightNoise::fillHeights(worldSeed, task.key.x * chunkSize, task.key.z * chunkSize, chunkSize, chunkSize,
+                                 chunkHeight, columnHeight.data());
+        break;
+    case GenStage::Carve:
+        chunk->carveTerrain(worldSeed, columnHeight.data(), caves);
+        break;
+    case GenStage::Surface:
+        chunk->coverSurface(columnHeight.data());
+        surface = std::make_shared<const ChunkSurface>(chunk->getSurface());
+        columnHeight = std::vector<int>();
+        break;
+    case GenStage::Ramps: {
+        const ChunkSurface* view[9];
+        for (int i = 0; i < 9; ++i) view[i] = around[i].get();
+        chunk->addRamps(view);
+        chunk->compactSections();
+        break;
+    }
+    case GenStage::Empty:
+        break;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    lk.lock();
+    times.runs[(int)task.stage]++;
+    times.nanos[(int)task.stage] += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    Proto& q = *protos.find(task.key);
+    q.chunk = std::move(chunk);
+    q.columnHeight = std::move(columnHeight);
+    if (surface) q.surface = std::move(surface);
+    q.stage = task.stage;
+    q.busy = false;
+    advanced.notify_all();
+}
+
+void ChunkPipeline::forget(int chunkX, int chunkZ) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (Proto* p = protos.find(ChunkKey{chunkX, chunkZ})) p->handedOut = false;
+    // only chunks within a ramp's reach of this one could have been kept for it
+    for (int dz = -1; dz <= 1; ++dz)
+        for (int dx = -1; dx <= 1; ++dx) dropIfUnneeded(ChunkKey{chunkX + dx, chunkZ + dz});
+}
+
+void ChunkPipeline::dropIfUnneeded(const ChunkKey& key) {
+    Proto* p = protos.find(key);
+    if (!p || p->busy) return;
+    for (int dz = -1; dz <= 1; ++dz)
+        for (int dx = -1; dx <= 1; ++dx) {
+            const Proto* n = protos.find(ChunkKey{key.x + dx, key.z + dz});
+            if (n && (n->requested || n->handedOut)) return;
+        }
+    pool->release(std::move(p->chunk));
+    protos.erase(key);
+}
+
+size_t ChunkPipeline::getPartialCount() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return protos.size();
+}
+
+ChunkPipeline::StageTimes ChunkPipeline::getStageTimes() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return times;
+}
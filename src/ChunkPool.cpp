@@ -0,0 +1,46 @@
+#include "ChunkPool.h"
+
+ChunkPool::ChunkPool(size_t maxFree_) : maxFree(maxFree_) {}
+
+std::unique_ptr<Chunk> ChunkPool::acquire(int chunkX, int chunkZ, int w, int h, int d) {
+    std::unique_ptr<Chunk> c;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stats.requests++;
+        stats.inUse++;
+        if (stats.inUse > stats.highWater) stats.highWater = stats.inUse;
+        if (!freeChunks.empty()) {
+            c = std::move(freeChunks.back());
+            freeChunks.pop_back();
+        }
+        if (c && (c->getWidth() != w || c->getHeight() != h || c->getDepth() != d))
+            c.reset(); // different dimensions: can't reuse
+        if (c) stats.hits++;
+    }
+    if (c) {
+        c->reset(chunkX, chunkZ);
+        return c;
+    }
+    return std::make_unique<Chunk>(chunkX, chunkZ, w, h, d);
+}
+
+void ChunkPool::release(std::unique_ptr<Chunk> chunk) {
+    if (!chunk) return;
+    // drop block buffers now rather than when the chunk is reused
+    chunk->reset(chunk->getChunkX(), chunk->getChunkZ());
+    std::lock_guard<std::mutex> lk(mtx);
+    stats.inUse--;
+    if (freeChunks.size() < maxFree) freeChunks.push_back(std::move(chunk));
+}
+
+ChunkRef ChunkPool::publish(std::unique_ptr<Chunk> chunk) {
+    std::shared_ptr<ChunkPool> self = shared_from_this();
+    return ChunkRef(chunk.release(), [self](const Chunk* c) {
+        self->release(std::unique_ptr<Chunk>(const_cast<Chunk*>(c)));
+    });
+}
+
+PoolStats ChunkPool::getStats() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return stats;
+}
@@ -1,4 +1,7 @@
 #include "Client.h"
+#include "Protocol.h"
+#include "ChunkLayout.h"
+#include "ChunkPipeline.h"
 #include <iostream>
 #include <cstring>
 #include <arpa/inet.h>
@@ -9,9 +12,50 @@
 Client::Client() {}
 Client::~Client() { disconnect(); }
 
-bool Client::connectToServer(const std::string& ip, uint16_t port) {
+bool Client::connectToServer(const std::string& ip, uint16_t port, bool localGeneration) {
     serverIP = ip; serverPort = port;
-    return connectTcp();
+    if (!connectTcp()) return false;
+    // without it every chunk still arrives whole
+    if (localGeneration) negotiateGeneration();
+    return true;
+}
+
+bool Client::negotiateGeneration() {
+    generator.reset();
+    ClientRequest req{(uint32_t)RequestType::WorldInfo, 0, 0, 0};
+    if (send(tcpSocket, &req, sizeof(req), 0) != (ssize_t)sizeof(req)) return false;
+    WorldInfoPacket info;
+    if (recv(tcpSocket, &info, sizeof(info), MSG_WAITALL) != (ssize_t)sizeof(info)) {
+        std::cerr << "Failed to receive world info\n";
+        return false;
+    }
+    if (info.generator != GENERATOR_VERSION) {
+        if (verbose)
+            std::cout << "Client: server runs generator " << info.generator << ", this build has "
+                      << GENERATOR_VERSION << "; receiving whole chunks\n";
+        return false;
+    }
+    if (info.layout != SectionLayout::id) {
+        if (verbose)
+            std::cout << "Client: server uses chunk layout " << (int)info.layout << ", this build has "
+                      << SectionLayout::name << "; receiving whole chunks\n";
+        return false;
+    }
+    if (info.chunkHeight != ChunkManager::CHUNK_HEIGHT) {
+        if (verbose)
+            std::cout << "Client: server chunks are " << info.chunkHeight << " high, this build has "
+                      << ChunkManager::CHUNK_HEIGHT << "; receiving whole chunks\n";
+        return false;
+    }
+    generator = std::make_unique<ChunkManager>(info.chunkSize);
+    generator->setWorldSeed(info.seed);
+    generator->setCaveSampling((CaveField::Sampling)info.caveSampling);
+    if (verbose) std::cout << "Client: generating terrain locally, seed " << info.seed << "\n";
+    return true;
+}
+
+void Client::releaseChunk(int chunkX, int chunkZ) {
+    if (generator) generator->unloadChunk(chunkX, chunkZ);
 }
 
 bool Client::connectTcp() {
@@ -23,13 +67,14 @@ bool Client::connectTcp() {
     if (connect(tcpSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0) { perror("connect"); close(tcpSocket); tcpSocket = -1; return false; }
 
     connected = true;
-    std::cout << "Client: connected to server\n";
+    if (verbose) std::cout << "Client: connected to server\n";
     return true;
 }
 
 void Client::disconnect() {
     if (tcpSocket != INVALID_SOCKET_VALUE) { close(tcpSocket); tcpSocket = INVALID_SOCKET_VALUE; }
     connected = false;
+    generator.reset();
 }
 
 ChunkData Client::requestChunk(uint32_t x, uint32_t y, uint32_t z) {
@@ -38,15 +83,13 @@ ChunkData Client::requestChunk(uint32_t x, uint32_t y, uint32_t z) {
         std::cerr << "Client not connected\n";
         return out;
     }
-    uint32_t coords[3] = {x,y,z};
-    if (send(tcpSocket, coords, sizeof(coords), 0) != (ssize_t)sizeof(coords)) {
+    RequestType type = generator ? RequestType::ChunkEdits : RequestType::Chunk;
+    ClientRequest req{(uint32_t)type, x, y, z};
+    if (send(tcpSocket, &req, sizeof(req), 0) != (ssize_t)sizeof(req)) {
         std::cerr << "Failed to send chunk request\n"; return out;
     }
     // receive header
-    struct ChunkPacketHeader {
-        uint32_t chunkX, chunkY, chunkZ;
-        uint16_t width, height, depth;
-    } header;
+    ChunkPacketHeader header;
     ssize_t got = recv(tcpSocket, &header, sizeof(header), MSG_WAITALL);
     if (got != (ssize_t)sizeof(header)) {
         std::cerr << "Failed to receive header got=" << got << std::endl;
@@ -55,13 +98,13 @@ ChunkData Client::requestChunk(uint32_t x, uint32_t y, uint32_t z) {
     out.chunkX = header.chunkX; out.chunkY = header.chunkY; out.chunkZ = header.chunkZ;
     out.width = header.width; out.height = header.height; out.depth = header.depth;
     
-    // FIXED: Server now sends 2 bytes per block (type + ramp direction)
-    size_t numBlocks = (size_t)out.width * out.height * out.depth;
-    size_t expectedBytes = numBlocks * 2; // 2 bytes per block now
-    out.blocks.resize(expectedBytes);
+    // Payload is the section-tagged encoding from Chunk::serialize(), or
+    // with ChunkEncoding::Edits the edits to apply to the generated chunk
+    size_t expectedBytes = header.payloadSize;
+    std::vector<uint8_t> payload(expectedBytes);
     
     size_t recvTotal = 0;
-    uint8_t* dest = out.blocks.data();
+    uint8_t* dest = payload.data();
     while (recvTotal < expectedBytes) {
         ssize_t r = recv(tcpSocket, dest + recvTotal, expectedBytes - recvTotal, 0);
         if (r <= 0) { 
@@ -70,8 +113,35 @@ ChunkData Client::requestChunk(uint32_t x, uint32_t y, uint32_t z) {
         }
         recvTotal += (size_t)r;
     }
-    std::cout << "Client: received chunk " << out.chunkX << "," << out.chunkZ 
-              << " blocks=" << numBlocks << " bytes=" << expectedBytes << "\n";
+    bytesReceived += sizeof(header) + expectedBytes;
+    if (header.layout != SectionLayout::id) {
+        // payload was still drained so the stream stays in sync
+        std::cerr << "Server uses chunk layout " << (int)header.layout << ", client was built with "
+                  << SectionLayout::name << "\n";
+        return ChunkData{};
+    }
+
+    if ((ChunkEncoding)header.encoding == ChunkEncoding::Edits) {
+        if (!generator) {
+            std::cerr << "Server sent chunk edits without world info\n";
+            return ChunkData{};
+        }
+        // generate the chunk here, exactly as the server did, and replay its edits
+        generator->loadChunk((int)x, (int)z);
+        ChunkRef generated = generator->getChunk((int)x, (int)z);
+        if (!generated) return ChunkData{};
+        auto chunk = std::make_shared<Chunk>(*generated);
+        if (!chunk->applyEdits(payload)) {
+            std::cerr << "Malformed edits for chunk " << out.chunkX << "," << out.chunkZ << "\n";
+            return ChunkData{};
+        }
+        out.chunk = std::move(chunk);
+    } else {
+        out.chunk = std::make_shared<const Chunk>((int)x, (int)z, out.width, out.height, out.depth, payload);
+    }
+    if (verbose)
+        std::cout << "Client: received chunk " << out.chunkX << "," << out.chunkZ << " bytes=" << expectedBytes
+                  << "\n";
     return out;
 }
 
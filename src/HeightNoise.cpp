@@ -0,0 +1,183 @@
+#include "HeightNoise.h"
+#include "HeightNoiseKernel.h"
+#include <FastNoiseLite.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// One-lane Ops for the kernel. Comparisons return all-ones / all-zero bit
+// patterns like the vector ones; integer arithmetic wraps.
+struct GenericOps {
+    using F = float;
+    using I = int32_t;
+    static constexpr int W = 1;
+
+    static F maskF(bool m) {
+        int32_t bits = m ? -1 : 0;
+        float f;
+        std::memcpy(&f, &bits, sizeof f);
+        return f;
+    }
+
+    static F set1f(float v) { return v; }
+    static I set1i(int v) { return v; }
+    static I iota() { return 0; }
+    static F add(F a, F b) { return a + b; }
+    static F sub(F a, F b) { return a - b; }
+    static F mul(F a, F b) { return a * b; }
+    static I addi(I a, I b) { return (I)((uint32_t)a + (uint32_t)b); }
+    static I muli(I a, I b) { return (I)((uint32_t)a * (uint32_t)b); }
+    static I xori(I a, I b) { return a ^ b; }
+    static I andi(I a, I b) { return a & b; }
+    static I orI(I a, I b) { return a | b; }
+    static I srai(I a, int n) { return a >> n; }
+    static F toF(I a) { return (F)a; }
+    static I truncI(F a) { return (I)a; }
+    static F lt(F a, F b) { return maskF(a < b); }
+    static F le(F a, F b) { return maskF(a <= b); }
+    static I maskI(F m) {
+        I bits;
+        std::memcpy(&bits, &m, sizeof bits);
+        return bits;
+    }
+    static F select(F m, F a, F b) { return maskI(m) ? a : b; }
+    static I selectI(I m, I a, I b) { return m ? a : b; }
+    static F gather(const float* table, I idx) { return table[idx]; }
+    static F load(const float* p) { return *p; }
+    static void store(float* p, F v) { *p = v; }
+    static void storei(int32_t* p, I v) { *p = v; }
+};
+
+} // namespace
+
+static bool cpuHas(HeightNoise::Simd simd) {
+#if defined(__x86_64__) || defined(__i386__)
+    switch (simd) {
+    case HeightNoise::Simd::SSE41: return __builtin_cpu_supports("sse4.1");
+    case HeightNoise::Simd::AVX2: return __builtin_cpu_supports("avx2");
+    default: return true;
+    }
+#else
+    return simd == HeightNoise::Simd::Scalar || simd == HeightNoise::Simd::Generic;
+#endif
+}
+
+HeightNoise::Simd HeightNoise::detect() {
+    // a kernel that was not built reports false even for an empty grid
+    static const Simd best = [] {
+        if (cpuHas(Simd::AVX2) && sampleAvx2(0, 0, 0, 0, 0, nullptr)) return Simd::AVX2;
+        if (cpuHas(Simd::SSE41) && sampleSse41(0, 0, 0, 0, 0, nullptr)) return Simd::SSE41;
+        return Simd::Generic;
+    }();
+    return best;
+}
+
+const char* HeightNoise::name(Simd simd) {
+    switch (simd) {
+    case Simd::SSE41: return "sse4.1";
+    case Simd::AVX2: return "avx2";
+    case Simd::Generic: return "generic";
+    default: return "scalar";
+    }
+}
+
+static void sampleScalar(int worldSeed, int originX, int originZ, int w, int d, float* out) {
+    FastNoiseLite baseNoise;
+    baseNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    baseNoise.SetFrequency(HeightNoise::BASE_FREQUENCY);
+    baseNoise.SetSeed(HeightNoise::BASE_SEED ^ worldSeed);
+
+    FastNoiseLite detailNoise;
+    detailNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    detailNoise.SetFrequency(HeightNoise::DETAIL_FREQUENCY);
+    detailNoise.SetSeed(HeightNoise::DETAIL_SEED ^ worldSeed);
+
+    for (int z = 0; z < d; ++z) {
+        for (int x = 0; x < w; ++x) {
+            float worldX = (float)(originX + x);
+            float worldZ = (float)(originZ + z);
+            float heightNoise = baseNoise.GetNoise(worldX, worldZ) * HeightNoise::BASE_AMPLITUDE;
+            float detail = detailNoise.GetNoise(worldX, worldZ) * HeightNoise::DETAIL_AMPLITUDE;
+            out[x + (size_t)w * z] = heightNoise + detail;
+        }
+    }
+}
+
+void HeightNoise::sample(int worldSeed, int originX, int originZ, int w, int d, float* out, Simd simd) {
+    // never run a kernel the CPU cannot execute, whatever the caller asked for
+    if (simd == Simd::AVX2) {
+        if (cpuHas(simd) && sampleAvx2(worldSeed, originX, originZ, w, d, out)) return;
+        simd = Simd::SSE41;
+    }
+    if (simd == Simd::SSE41) {
+        if (cpuHas(simd) && sampleSse41(worldSeed, originX, originZ, w, d, out)) return;
+        simd = Simd::Generic;
+    }
+    if (simd == Simd::Generic) NoiseKernel<GenericOps, HeightNoise>::sample(worldSeed, originX, originZ, w, d, out);
+    else sampleScalar(worldSeed, originX, originZ, w, d, out);
+}
+
+// Unclamped surface y for one column's noise value.
+static int curveHeight(float noise, int chunkHeight) {
+    // Gentle smoothing curve
+    float combinedNoise = powf(noise * 0.5f + 0.5f, 1.1f) * 2.0f - 1.0f;
+
+    // Mostly flat with gentle undulations
+    int terrainHeight = (int)((combinedNoise + 1.0f) * 0.5f * (chunkHeight * 0.2f)) + chunkHeight * 0.5f;
+    return terrainHeight;
+}
+
+// curveHeight is monotonic in the noise and only spans about chunkHeight / 5
+// values, so it can be replaced exactly by counting how many precomputed
+// step thresholds a noise value reaches. That skips powf on every column.
+struct CurveSteps {
+    int chunkHeight = -1;
+    int base = 0;              // height at noise -1
+    std::vector<float> steps;  // smallest noise reaching base + 1, base + 2, ...
+
+    void build(int h) {
+        chunkHeight = h;
+        base = curveHeight(-1.0f, h);
+        steps.clear();
+        for (int k = base + 1; k <= curveHeight(1.0f, h); ++k) {
+            // bisect down to adjacent floats: lo < k <= hi
+            float lo = -1.0f, hi = 1.0f;
+            for (;;) {
+                float mid = lo + (hi - lo) * 0.5f;
+                if (mid == lo || mid == hi) break;
+                (curveHeight(mid, h) >= k ? hi : lo) = mid;
+            }
+            steps.push_back(hi);
+        }
+    }
+};
+
+void HeightNoise::fillHeights(int worldSeed, int originX, int originZ, int w, int d, int chunkHeight, int* out, Simd simd) {
+    std::vector<float> noise((size_t)w * d);
+    sample(worldSeed, originX, originZ, w, d, noise.data(), simd);
+
+    if (simd == Simd::Scalar) {
+        for (size_t i = 0; i < noise.size(); ++i)
+            out[i] = std::max(1, std::min(curveHeight(noise[i], chunkHeight), chunkHeight - 1));
+        return;
+    }
+
+    thread_local CurveSteps curve;
+    if (curve.chunkHeight != chunkHeight) curve.build(chunkHeight);
+
+    const int n = w * d;
+    const float* steps = curve.steps.data();
+    const int stepCount = (int)curve.steps.size();
+    // same fallback order as sample()
+    if (simd == Simd::AVX2) {
+        if (cpuHas(simd) && heightsAvx2(noise.data(), n, steps, stepCount, curve.base, chunkHeight - 1, out)) return;
+        simd = Simd::SSE41;
+    }
+    if (simd == Simd::SSE41) {
+        if (cpuHas(simd) && heightsSse41(noise.data(), n, steps, stepCount, curve.base, chunkHeight - 1, out)) return;
+    }
+    NoiseKernel<GenericOps, HeightNoise>::heights(noise.data(), n, steps, stepCount, curve.base, chunkHeight - 1, out);
+}
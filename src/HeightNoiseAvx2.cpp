@@ -0,0 +1,58 @@
+// AVX2 HeightNoise kernel (8 lanes). Built with -mavx2; see the Makefile.
+#include "HeightNoise.h"
+
+#ifdef __AVX2__
+#include "HeightNoiseKernel.h"
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2Ops {
+    using F = __m256;
+    using I = __m256i;
+    static constexpr int W = 8;
+
+    static F set1f(float v) { return _mm256_set1_ps(v); }
+    static I set1i(int v) { return _mm256_set1_epi32(v); }
+    static I iota() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I muli(I a, I b) { return _mm256_mullo_epi32(a, b); }
+    static I xori(I a, I b) { return _mm256_xor_si256(a, b); }
+    static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+    static I orI(I a, I b) { return _mm256_or_si256(a, b); }
+    static I srai(I a, int n) { return _mm256_srai_epi32(a, n); }
+    static F toF(I a) { return _mm256_cvtepi32_ps(a); }
+    static I truncI(F a) { return _mm256_cvttps_epi32(a); }
+    static F lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static F le(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static I maskI(F m) { return _mm256_castps_si256(m); }
+    static F select(F m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+    static I selectI(I m, I a, I b) { return _mm256_blendv_epi8(b, a, m); }
+    static F gather(const float* table, I idx) { return _mm256_i32gather_ps(table, idx, 4); }
+    static F load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static void storei(int32_t* p, I v) { _mm256_storeu_si256((I*)p, v); }
+};
+
+} // namespace
+
+bool HeightNoise::sampleAvx2(int worldSeed, int originX, int originZ, int w, int d, float* out) {
+    NoiseKernel<Avx2Ops, HeightNoise>::sample(worldSeed, originX, originZ, w, d, out);
+    return true;
+}
+
+bool HeightNoise::heightsAvx2(const float* noise, int n, const float* steps, int stepCount, int base, int maxHeight,
+                              int* out) {
+    NoiseKernel<Avx2Ops, HeightNoise>::heights(noise, n, steps, stepCount, base, maxHeight, out);
+    return true;
+}
+
+#else
+
+bool HeightNoise::sampleAvx2(int, int, int, int, int, float*) { return false; }
+bool HeightNoise::heightsAvx2(const float*, int, const float*, int, int, int, int*) { return false; }
+
+#endif
@@ -0,0 +1,62 @@
+// SSE4.1 HeightNoise kernel (4 lanes). Built with -msse4.1; see the Makefile.
+#include "HeightNoise.h"
+
+#ifdef __SSE4_1__
+#include "HeightNoiseKernel.h"
+#include <smmintrin.h>
+
+namespace {
+
+struct Sse41Ops {
+    using F = __m128;
+    using I = __m128i;
+    static constexpr int W = 4;
+
+    static F set1f(float v) { return _mm_set1_ps(v); }
+    static I set1i(int v) { return _mm_set1_epi32(v); }
+    static I iota() { return _mm_setr_epi32(0, 1, 2, 3); }
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+    static I muli(I a, I b) { return _mm_mullo_epi32(a, b); }
+    static I xori(I a, I b) { return _mm_xor_si128(a, b); }
+    static I andi(I a, I b) { return _mm_and_si128(a, b); }
+    static I orI(I a, I b) { return _mm_or_si128(a, b); }
+    static I srai(I a, int n) { return _mm_srai_epi32(a, n); }
+    static F toF(I a) { return _mm_cvtepi32_ps(a); }
+    static I truncI(F a) { return _mm_cvttps_epi32(a); }
+    static F lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static F le(F a, F b) { return _mm_cmple_ps(a, b); }
+    static I maskI(F m) { return _mm_castps_si128(m); }
+    static F select(F m, F a, F b) { return _mm_blendv_ps(b, a, m); }
+    static I selectI(I m, I a, I b) { return _mm_blendv_epi8(b, a, m); }
+    static F gather(const float* table, I idx) {
+        alignas(16) int i[4];
+        _mm_store_si128((__m128i*)i, idx);
+        return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+    }
+    static F load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, F v) { _mm_storeu_ps(p, v); }
+    static void storei(int32_t* p, I v) { _mm_storeu_si128((I*)p, v); }
+};
+
+} // namespace
+
+bool HeightNoise::sampleSse41(int worldSeed, int originX, int originZ, int w, int d, float* out) {
+    NoiseKernel<Sse41Ops, HeightNoise>::sample(worldSeed, originX, originZ, w, d, out);
+    return true;
+}
+
+bool HeightNoise::heightsSse41(const float* noise, int n, const float* steps, int stepCount, int base, int maxHeight,
+                               int* out) {
+    NoiseKernel<Sse41Ops, HeightNoise>::heights(noise, n, steps, stepCount, base, maxHeight, out);
+    return true;
+}
+
+#else
+
+bool HeightNoise::sampleSse41(int, int, int, int, int, float*) { return false; }
+bool HeightNoise::heightsSse41(const float*, int, const float*, int, int, int, int*) { return false; }
+
+#endif
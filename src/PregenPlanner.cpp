@@ -0,0 +1,51 @@
+#include "PregenPlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+std::vector<ChunkKey> PregenPlanner::update(ChunkKey pc, int rd) {
+    history.push_back(pc);
+    if (history.size() > HISTORY) history.pop_front();
+
+    // soonest step at which each chunk enters the render square
+    ChunkMap<int> eta;
+    auto consider = [&](ChunkKey k, int steps) {
+        if (std::abs(k.x - pc.x) <= rd && std::abs(k.z - pc.z) <= rd) return;
+        auto ins = eta.emplace(k, steps);
+        if (!ins.second) *ins.first = std::min(*ins.first, steps);
+    };
+
+    for (int dz = -rd - RINGS; dz <= rd + RINGS; ++dz)
+        for (int dx = -rd - RINGS; dx <= rd + RINGS; ++dx)
+            consider(ChunkKey{pc.x + dx, pc.z + dz}, std::max(std::abs(dx), std::abs(dz)) - rd);
+
+    float hx = (float)(pc.x - history.front().x), hz = (float)(pc.z - history.front().z);
+    float len = std::sqrt(hx * hx + hz * hz);
+    if (len > 0.0f) {
+        hx /= len;
+        hz /= len;
+        for (int k = 1; k <= AHEAD; ++k) {
+            int ax = pc.x + (int)std::lround(hx * k), az = pc.z + (int)std::lround(hz * k);
+            for (int dz = -rd; dz <= rd; ++dz)
+                for (int dx = -rd; dx <= rd; ++dx) consider(ChunkKey{ax + dx, az + dz}, k);
+        }
+    }
+
+    std::vector<std::pair<ChunkKey, int>> order;
+    order.reserve(eta.size());
+    for (auto& kv : eta) order.push_back(kv);
+    auto dist2 = [&](const ChunkKey& k) {
+        long dx = k.x - pc.x, dz = k.z - pc.z;
+        return dx * dx + dz * dz;
+    };
+    std::sort(order.begin(), order.end(), [&](const std::pair<ChunkKey, int>& a, const std::pair<ChunkKey, int>& b) {
+        if (a.second != b.second) return a.second < b.second;
+        if (dist2(a.first) != dist2(b.first)) return dist2(a.first) < dist2(b.first);
+        return chunkKeyCode(a.first) < chunkKeyCode(b.first);
+    });
+
+    std::vector<ChunkKey> targets;
+    targets.reserve(order.size());
+    for (auto& kv : order) targets.push_back(kv.first);
+    return targets;
+}
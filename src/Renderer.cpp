@@ -1,9 +1,11 @@
 // Renderer.cpp
 #include "Renderer.h"
+#include "Block.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 #include <cstring> // for offsetof
 #include <cassert>
 #include <string>
@@ -35,10 +37,10 @@ Renderer::Renderer(int screenWidth, int screenHeight,
   if (vs) glDeleteShader(vs);
   if (fs) glDeleteShader(fs);
 
-  // Ensure we have buffers and attribute setup ready
-  createEmptyMeshBuffers();
+  // every chunk VAO binds this, so it must exist before the first mesh
+  glGenBuffers(1, &quadIndices);
 
-  // populate VBO with default cube so we don't draw nothing initially
+  // populate a mesh with default cube so we don't draw nothing initially
   initCube();
 
   // load texture from assets folder by default
@@ -57,8 +59,8 @@ Renderer::Renderer(int screenWidth, int screenHeight,
 Renderer::~Renderer() {
   if (shaderProgram) glDeleteProgram(shaderProgram);
   if (texture) glDeleteTextures(1, &texture);
-  if (VBO) glDeleteBuffers(1, &VBO);
-  if (VAO) glDeleteVertexArrays(1, &VAO);
+  for (auto &entry : meshes) deleteMeshBuffers(entry.second);
+  if (quadIndices) glDeleteBuffers(1, &quadIndices);
 }
 
 void Renderer::setView(const glm::mat4 &viewMatrix) { view = viewMatrix; }
@@ -146,46 +148,85 @@ GLuint Renderer::loadTexture(const std::string &path) {
   return textureID;
 }
 
-void Renderer::createEmptyMeshBuffers() {
-    if (VAO == 0) glGenVertexArrays(1, &VAO);
-    if (VBO == 0) glGenBuffers(1, &VBO);
+void Renderer::createMeshBuffers(ChunkBuffers& mesh) {
+    glGenVertexArrays(1, &mesh.VAO);
+    glGenBuffers(1, &mesh.VBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindVertexArray(mesh.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    // the VAO remembers the index buffer; growing it keeps the same name
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndices);
 
-    // position (location = 0)
+    // packed position (location = 0)
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          reinterpret_cast<void*>(offsetof(Vertex, pos)));
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(Vertex),
+                           reinterpret_cast<void*>(offsetof(Vertex, pos)));
 
-    // texcoord (location = 1)
+    // packed texcoord and atlas tile (location = 1)
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          reinterpret_cast<void*>(offsetof(Vertex, tex)));
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(Vertex),
+                           reinterpret_cast<void*>(offsetof(Vertex, tex)));
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void Renderer::setMesh(const std::vector<Vertex>& vertices) {
-    createEmptyMeshBuffers(); // ensure buffers & attribs exist
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    if (!vertices.empty()) {
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_DYNAMIC_DRAW);
-        vertexCount = vertices.size();
-    } else {
-        // empty mesh
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-        vertexCount = 0;
+void Renderer::deleteMeshBuffers(ChunkBuffers& mesh) {
+    if (mesh.VBO) glDeleteBuffers(1, &mesh.VBO);
+    if (mesh.VAO) glDeleteVertexArrays(1, &mesh.VAO);
+    mesh = ChunkBuffers();
+}
+
+void Renderer::reserveQuadIndices(size_t quads) {
+    if (quads <= quadIndexCapacity) return;
+    size_t capacity = std::max<size_t>(quadIndexCapacity * 2, std::max<size_t>(quads, 1024));
+    std::vector<GLuint> indices;
+    indices.reserve(capacity * 6);
+    for (GLuint q = 0; q < capacity; ++q)
+        for (GLuint i : {0u, 1u, 2u, 2u, 3u, 0u}) indices.push_back(q * 4 + i);
+
+    // bound outside any VAO so no chunk's binding changes
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndices);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    quadIndexCapacity = capacity;
+}
+
+void Renderer::setChunkMesh(const ChunkKey& key, const glm::vec3& origin, const ChunkMesh& chunkMesh) {
+    if (chunkMesh.empty()) {
+        removeChunkMesh(key);
+        return;
     }
+    reserveQuadIndices(chunkMesh.quads.size() / 4);
+    ChunkBuffers* mesh = meshes.find(key);
+    if (!mesh) {
+        mesh = meshes.emplace(key, ChunkBuffers()).first;
+        createMeshBuffers(*mesh);
+    }
+    mesh->origin = origin;
+
+    // quads first, so their indices start at 0, then the triangles
+    const size_t quadBytes = chunkMesh.quads.size() * sizeof(Vertex);
+    const size_t triangleBytes = chunkMesh.triangles.size() * sizeof(Vertex);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->VBO);
+    glBufferData(GL_ARRAY_BUFFER, quadBytes + triangleBytes, nullptr, GL_DYNAMIC_DRAW);
+    if (quadBytes) glBufferSubData(GL_ARRAY_BUFFER, 0, quadBytes, chunkMesh.quads.data());
+    if (triangleBytes) glBufferSubData(GL_ARRAY_BUFFER, quadBytes, triangleBytes, chunkMesh.triangles.data());
+    mesh->quadVertices = chunkMesh.quads.size();
+    mesh->triangleVertices = chunkMesh.triangles.size();
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+}
+
+void Renderer::removeChunkMesh(const ChunkKey& key) {
+    if (ChunkBuffers* mesh = meshes.find(key)) {
+        deleteMeshBuffers(*mesh);
+        meshes.erase(key);
+    }
 }
 
 void Renderer::initCube() {
-  // creates a small 1x1 cube mesh and uploads it via setMesh()
+  // creates a small 1x1 cube mesh and uploads it via setChunkMesh()
   float raw[] = {
       // back face
       -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
@@ -231,24 +272,25 @@ void Renderer::initCube() {
       -0.5f,  0.5f, -0.5f, 0.0f, 1.0f
   };
 
-  const int verts = 36;
-  std::vector<Vertex> cube;
-  cube.reserve(verts);
-  for (int i = 0; i < verts; ++i) {
-      Vertex v;
-      v.pos = glm::vec3(raw[i*5 + 0], raw[i*5 + 1], raw[i*5 + 2]);
-      v.tex = glm::vec2(raw[i*5 + 3], raw[i*5 + 4]);
-      cube.push_back(v);
+  // each face is a, b, c, c, d, a; the quad keeps a, b, c, d
+  ChunkMesh cube;
+  cube.quads.reserve(24);
+  for (int f = 0; f < 6; ++f) {
+      for (int c : {0, 1, 2, 4}) {
+          int i = f * 6 + c;
+          cube.quads.push_back(Vertex::pack(glm::vec3(raw[i*5 + 0], raw[i*5 + 1], raw[i*5 + 2]),
+                                            glm::vec2(raw[i*5 + 3], raw[i*5 + 4]), 0));
+      }
   }
 
-  setMesh(cube);
+  setChunkMesh(ChunkKey{0, 0}, glm::vec3(0.0f), cube);
 }
 
 // ----------------- end mesh helpers -----------------
 
 void Renderer::render() {
     if (!shaderProgram) return;
-    if (vertexCount == 0) return; // nothing to draw
+    if (meshes.empty()) return; // nothing to draw
 
     glUseProgram(shaderProgram);
 
@@ -275,7 +317,23 @@ void Renderer::render() {
     if (texLoc != -1)
         glUniform1i(texLoc, 0);
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertexCount));
+    GLint tilesLoc = glGetUniformLocation(shaderProgram, "uAtlasTiles");
+    if (tilesLoc != -1)
+        glUniform1f(tilesLoc, (float)ATLAS_TILES);
+
+    // per chunk, its vertices offset by the chunk's origin: the quads through
+    // the shared indices, then the triangles after them
+    GLint originLoc = glGetUniformLocation(shaderProgram, "uChunkOrigin");
+    for (const auto& entry : meshes) {
+        const ChunkBuffers& mesh = entry.second;
+        if (originLoc != -1)
+            glUniform3fv(originLoc, 1, glm::value_ptr(mesh.origin));
+        glBindVertexArray(mesh.VAO);
+        if (mesh.quadVertices)
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.quadVertices / 4 * 6), GL_UNSIGNED_INT, nullptr);
+        if (mesh.triangleVertices)
+            glDrawArrays(GL_TRIANGLES, static_cast<GLint>(mesh.quadVertices),
+                         static_cast<GLsizei>(mesh.triangleVertices));
+    }
     glBindVertexArray(0);
 }
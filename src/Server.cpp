@@ -1,8 +1,13 @@
 #include "Server.h"
+#include "Protocol.h"
 #include <cstring>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <limits>
 
 #ifdef _WIN32
 // Windows sockets omitted for brevity
@@ -19,6 +24,14 @@ Server::Server(uint16_t port_) : port(port_), running(false) {
     udpSocket.store(INVALID_SOCKET_VALUE);
     tcpSocket.store(INVALID_SOCKET_VALUE);
     chunkManager = std::make_unique<ChunkManager>(16, 4);
+    // serve chunks pregenerated by tools/Pregen, if there are any
+    if (std::filesystem::is_directory(WORLD_DIR)) {
+        auto storage = std::make_shared<WorldStorage>();
+        if (storage->open(WORLD_DIR, chunkManager->getWorldSeed(), chunkManager->getChunkSize(),
+                          ChunkManager::CHUNK_HEIGHT, chunkManager->getCaveSampling()))
+            chunkManager->setStorage(std::move(storage));
+    }
+    genPool = std::make_unique<ChunkGenPool>(*chunkManager);
 }
 
 Server::~Server() {
@@ -86,9 +99,10 @@ void Server::run() {
         return;
     }
 
-    std::cout << "Server running on port " << port << " (UDP+TCP)\n";
+    if (verbose) std::cout << "Server running on port " << port << " (UDP+TCP)\n";
 
-    std::vector<socket_t> tcpClients;
+    std::vector<TcpClient> tcpClients;
+    glm::ivec2 lastPlayerChunk(std::numeric_limits<int>::min());
 
     while (running) {
         fd_set readfds;
@@ -96,25 +110,45 @@ void Server::run() {
         FD_SET(udp_sock, &readfds);
         FD_SET(tcp_sock, &readfds);
         socket_t maxfd = std::max(udp_sock, tcp_sock);
-        for (auto c : tcpClients) { FD_SET(c, &readfds); maxfd = std::max(maxfd, c); }
+        bool waiting = false;
+        for (auto &c : tcpClients) {
+            FD_SET(c.sock, &readfds);
+            maxfd = std::max(maxfd, c.sock);
+            waiting = waiting || !c.pending.empty();
+        }
 
-        struct timeval tv{0, 100000}; // 100ms
+        // poll quickly while clients wait on generation
+        struct timeval tv{0, waiting ? 2000 : 100000};
         int res = select((int)maxfd + 1, &readfds, nullptr, nullptr, &tv);
         if (res < 0) {
             if (errno == EINTR) continue;
             break;
         }
 
-        // update server-side chunk manager around player if available
+        // queue generation around the player when they enter a new chunk;
+        // the pool works nearest-first without holding up this thread, and
+        // spends idle time on what lies ahead of them
         if (player) {
-            // compute player's chunk coords and ensure nearby chunks exist
             glm::vec3 chunkCoords = player->getChunkCoordinates(chunkManager->getChunkSize());
-            int cx = (int)chunkCoords.x;
-            int cz = (int)chunkCoords.z;
-            int rd = chunkManager->getRenderDistance();
-            for (int dx=-rd; dx<=rd; ++dx)
-                for (int dz=-rd; dz<=rd; ++dz)
-                    chunkManager->loadChunk(cx+dx, cz+dz);
+            glm::ivec2 pc((int)std::floor(chunkCoords.x), (int)std::floor(chunkCoords.z));
+            if (pc != lastPlayerChunk) {
+                lastPlayerChunk = pc;
+                genPool->setPlayerChunks({ChunkKey{pc.x, pc.y}});
+                int rd = chunkManager->getRenderDistance();
+                for (int dx=-rd; dx<=rd; ++dx)
+                    for (int dz=-rd; dz<=rd; ++dz)
+                        genPool->request(pc.x+dx, pc.y+dz);
+                genPool->setPregenTargets(pregenPlanner.update(ChunkKey{pc.x, pc.y}, rd));
+            }
+        }
+
+        for (auto it = tcpClients.begin(); it != tcpClients.end();) {
+            if (!flushPendingChunks(*it)) {
+                close(it->sock);
+                it = tcpClients.erase(it);
+                continue;
+            }
+            ++it;
         }
 
         if (res == 0) continue;
@@ -124,8 +158,8 @@ void Server::run() {
             socklen_t addrLen = sizeof(clientAddr);
             int clientSock = accept(tcp_sock, (struct sockaddr*)&clientAddr, &addrLen);
             if (clientSock >= 0) {
-                tcpClients.push_back(clientSock);
-                std::cout << "New TCP client\n";
+                tcpClients.push_back(TcpClient{clientSock, {}});
+                if (verbose) std::cout << "New TCP client\n";
             }
         }
 
@@ -134,10 +168,9 @@ void Server::run() {
         }
 
         for (auto it = tcpClients.begin(); it != tcpClients.end();) {
-            socket_t s = *it;
-            if (FD_ISSET(s, &readfds)) {
-                if (!handleTcpRequest(s)) {
-                    close(s);
+            if (FD_ISSET(it->sock, &readfds)) {
+                if (!handleTcpRequest(*it) || !flushPendingChunks(*it)) {
+                    close(it->sock);
                     it = tcpClients.erase(it);
                     continue;
                 }
@@ -147,11 +180,19 @@ void Server::run() {
     }
 
     // cleanup
-    for (auto c : tcpClients) close(c);
+    for (auto &c : tcpClients) close(c.sock);
     close(udp_sock);
     close(tcp_sock);
     udpSocket.store(INVALID_SOCKET_VALUE);
     tcpSocket.store(INVALID_SOCKET_VALUE);
+    if (!verbose) return;
+    PoolStats cp = chunkManager->getChunkPoolStats();
+    PoolStats bp = chunkManager->getBufferPoolStats();
+    std::cout << "Server: chunk pool hit rate " << cp.hitRate() * 100.0 << "% (high water " << cp.highWater
+              << "), block buffer pool hit rate " << bp.hitRate() * 100.0 << "% (high water " << bp.highWater << ")\n";
+    ChunkGenPool::PregenStats ps = genPool->getPregenStats();
+    std::cout << "Server: pregenerated " << ps.generated << " chunks, " << ps.hits << " later requests found one ready, "
+              << ps.early << " found one in progress\n";
     std::cout << "Server stopped\n";
 }
 
@@ -165,47 +206,99 @@ void Server::handleUdpRequest(socket_t sock) {
     sendto(sock, resp, (int)strlen(resp), 0, (struct sockaddr*)&caddr, len);
 }
 
-bool Server::handleTcpRequest(socket_t clientSock) {
-    // Expect 3x uint32_t chunk coords from client
-    uint32_t coords[3];
-    ssize_t got = recv(clientSock, coords, sizeof(coords), 0);
-    if (got != (ssize_t)sizeof(coords)) {
+bool Server::handleTcpRequest(TcpClient& client) {
+    ClientRequest req;
+    ssize_t got = recv(client.sock, &req, sizeof(req), 0);
+    if (got != (ssize_t)sizeof(req)) {
         // may be client closed or sent partial -> treat as disconnect
         return false;
     }
-    uint32_t cx = coords[0], cy = coords[1], cz = coords[2];
-    std::cout << "Server: chunk request " << cx << "," << cy << "," << cz << "\n";
+    RequestType type = (RequestType)req.type;
+    uint32_t cx = req.chunkX, cy = req.chunkY, cz = req.chunkZ;
+    switch (type) {
+    case RequestType::Chunk:
+        if (verbose) std::cout << "Server: chunk request " << cx << "," << cy << "," << cz << "\n";
+        // generated on the pool; answered by flushPendingChunks once ready
+        client.pending.push_back(PendingChunk{type, cx, cy, cz, genPool->request((int)cx, (int)cz)});
+        return true;
+    case RequestType::ChunkEdits:
+        if (verbose) std::cout << "Server: chunk edits request " << cx << "," << cy << "," << cz << "\n";
+        // the client generates the chunk itself; nothing to wait for
+        client.pending.push_back(PendingChunk{type, cx, cy, cz, {}});
+        return true;
+    case RequestType::WorldInfo:
+        client.pending.push_back(PendingChunk{type, cx, cy, cz, {}});
+        return true;
+    }
+    std::cerr << "Server: unknown request type " << req.type << "\n";
+    return false;
+}
 
-    // Ensure chunk exists on server
-    chunkManager->loadChunk((int)cx, (int)cz);
-    Chunk* ch = chunkManager->getChunk((int)cx, (int)cz);
-    if (!ch) return false;
+bool Server::flushPendingChunks(TcpClient& client) {
+    while (!client.pending.empty()) {
+        PendingChunk& p = client.pending.front();
+        if (p.type == RequestType::WorldInfo) {
+            if (!sendWorldInfo(client.sock)) return false;
+        } else if (p.type == RequestType::ChunkEdits) {
+            // only setBlock edits differ from what the client generates; a
+            // chunk that isn't loaded has none
+            std::vector<BlockEdit> edits;
+            ChunkRef ch = chunkManager->getChunkWithEdits((int)p.cx, (int)p.cz, edits);
+            if (!sendChunk(client.sock, p.cx, p.cy, p.cz, ch, ChunkEncoding::Edits, edits)) return false;
+        } else {
+            if (p.handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return true;
+            // a later edit may have replaced the generated version; send the latest
+            ChunkRef ch = chunkManager->getChunk((int)p.cx, (int)p.cz);
+            if (!ch) ch = p.handle.get();
+            if (!ch || !sendChunk(client.sock, p.cx, p.cy, p.cz, ch)) return false;
+        }
+        client.pending.pop_front();
+    }
+    return true;
+}
+
+bool Server::sendWorldInfo(socket_t clientSock) {
+    WorldInfoPacket info{};
+    info.seed = chunkManager->getWorldSeed();
+    info.generator = GENERATOR_VERSION;
+    info.chunkSize = (uint16_t)chunkManager->getChunkSize();
+    info.chunkHeight = (uint16_t)ChunkManager::CHUNK_HEIGHT;
+    info.layout = SectionLayout::id;
+    info.caveSampling = (uint8_t)chunkManager->getCaveSampling();
+    return send(clientSock, &info, sizeof(info), 0) == (ssize_t)sizeof(info);
+}
 
-    struct ChunkPacketHeader {
-        uint32_t chunkX, chunkY, chunkZ;
-        uint16_t width, height, depth;
-    } header;
+bool Server::sendChunk(socket_t clientSock, uint32_t cx, uint32_t cy, uint32_t cz, const ChunkRef& ch,
+                       ChunkEncoding encoding, const std::vector<BlockEdit>& edits) {
+    // Sections that are all air or a single type are sent as a 2-byte tag
+    std::vector<uint8_t> packedData;
+    if (encoding == ChunkEncoding::Edits) {
+        packedData = Chunk::serializeEdits(edits);
+        if (!edits.empty()) {
+            std::vector<uint8_t> whole = ch->serialize();
+            if (whole.size() <= packedData.size()) {
+                packedData = std::move(whole);
+                encoding = ChunkEncoding::Blocks;
+            }
+        }
+    } else {
+        packedData = ch->serialize();
+    }
 
+    ChunkPacketHeader header;
     header.chunkX = cx;
     header.chunkY = cy;
     header.chunkZ = cz;
-    header.width = (uint16_t)ch->getWidth();
-    header.height = (uint16_t)ch->getHeight();
-    header.depth = (uint16_t)ch->getDepth();
-
-    // send header
-    if (send(clientSock, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) return false;
+    header.width = (uint16_t)(ch ? ch->getWidth() : chunkManager->getChunkSize());
+    header.height = (uint16_t)(ch ? ch->getHeight() : ChunkManager::CHUNK_HEIGHT);
+    header.depth = (uint16_t)(ch ? ch->getDepth() : chunkManager->getChunkSize());
+    header.payloadSize = (uint32_t)packedData.size();
+    header.layout = SectionLayout::id;
+    header.encoding = (uint8_t)encoding;
 
-    // FIXED: Send both block type and ramp direction as packed bytes
-    const auto& blocks = ch->getBlocks();
-    std::vector<uint8_t> packedData;
-    packedData.reserve(blocks.size() * 2); // 2 bytes per block
-    
-    // Pack block type and ramp direction into separate bytes
-    for (const auto& block : blocks) {
-        packedData.push_back(static_cast<uint8_t>(block.type));
-        packedData.push_back(static_cast<uint8_t>(block.ramp));
-    }
+    // send header; held back to go out with the payload, or a small edit
+    // list would wait on the client's delayed ack
+    if (send(clientSock, &header, sizeof(header), MSG_MORE) != (ssize_t)sizeof(header)) return false;
 
     // send packed data
     size_t totalBytes = packedData.size();
@@ -217,6 +310,10 @@ bool Server::handleTcpRequest(socket_t clientSock) {
         sent += (size_t)s;
     }
     
-    std::cout << "Server: sent chunk data (" << totalBytes << " bytes = " << blocks.size() << " blocks)\n";
+    if (encoding == ChunkEncoding::Edits) {
+        if (verbose) std::cout << "Server: sent " << edits.size() << " chunk edits (" << totalBytes << " bytes)\n";
+        return true;
+    }
+    if (verbose) std::cout << "Server: sent chunk data (" << totalBytes << " bytes)\n";
     return true;
 }
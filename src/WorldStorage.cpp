@@ -0,0 +1,179 @@
+#include "WorldStorage.h"
+#include "ChunkLayout.h"
+#include "ChunkPipeline.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+// world.dat: what every chunk in the directory was generated with
+struct WorldInfo {
+    char magic[4];
+    uint32_t generator;
+    int32_t seed;
+    uint16_t chunkSize, chunkHeight;
+    uint8_t layout;       // SectionLayout::id
+    uint8_t caveSampling; // CaveField::Sampling; was zeroed padding (Exact) before it was recorded
+};
+
+constexpr char WORLD_MAGIC[4] = {'B', 'M', 'C', 'W'};
+constexpr char REGION_MAGIC[4] = {'B', 'M', 'C', 'R'};
+constexpr size_t REGION_CHUNKS = (size_t)WorldStorage::REGION_SIZE * WorldStorage::REGION_SIZE;
+
+int floorDivRegion(int v) { return v >= 0 ? v / WorldStorage::REGION_SIZE : (v + 1) / WorldStorage::REGION_SIZE - 1; }
+
+// a chunk's slot in its region's table
+size_t entryIndex(int chunkX, int chunkZ) {
+    int lx = chunkX - floorDivRegion(chunkX) * WorldStorage::REGION_SIZE;
+    int lz = chunkZ - floorDivRegion(chunkZ) * WorldStorage::REGION_SIZE;
+    return (size_t)lx + (size_t)WorldStorage::REGION_SIZE * lz;
+}
+
+} // namespace
+
+bool WorldStorage::open(const std::string& dir_, int32_t worldSeed, int chunkSize, int chunkHeight,
+                        CaveField::Sampling caves) {
+    std::lock_guard<std::mutex> lk(mtx);
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    if (ec) {
+        std::cerr << "WorldStorage: can't create " << dir_ << ": " << ec.message() << "\n";
+        return false;
+    }
+
+    WorldInfo want{};
+    std::memcpy(want.magic, WORLD_MAGIC, sizeof(want.magic));
+    want.generator = GENERATOR_VERSION;
+    want.seed = worldSeed;
+    want.chunkSize = (uint16_t)chunkSize;
+    want.chunkHeight = (uint16_t)chunkHeight;
+    want.layout = SectionLayout::id;
+    want.caveSampling = (uint8_t)caves;
+
+    std::string infoPath = dir_ + "/world.dat";
+    std::ifstream in(infoPath, std::ios::binary);
+    if (in) {
+        WorldInfo have{};
+        in.read(reinterpret_cast<char*>(&have), sizeof(have));
+        if (!in || std::memcmp(have.magic, WORLD_MAGIC, sizeof(have.magic)) != 0) {
+            std::cerr << "WorldStorage: " << infoPath << " is not a world file\n";
+            return false;
+        }
+        if (have.generator != want.generator || have.seed != want.seed || have.chunkSize != want.chunkSize ||
+            have.chunkHeight != want.chunkHeight || have.layout != want.layout ||
+            have.caveSampling != want.caveSampling) {
+            std::cerr << "WorldStorage: " << dir_ << " holds seed " << have.seed << ", generator "
+                      << have.generator << ", " << have.chunkSize << "x" << have.chunkHeight << " chunks, layout "
+                      << (int)have.layout << ", cave sampling " << (int)have.caveSampling << "; wanted seed "
+                      << want.seed << ", generator " << want.generator << ", " << want.chunkSize << "x"
+                      << want.chunkHeight << " chunks, layout " << (int)want.layout << ", cave sampling "
+                      << (int)want.caveSampling << "\n";
+            return false;
+        }
+    } else {
+        std::ofstream out(infoPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&want), sizeof(want));
+        if (!out) {
+            std::cerr << "WorldStorage: can't write " << infoPath << "\n";
+            return false;
+        }
+    }
+
+    dir = dir_;
+    regions.clear();
+    bytesWritten = 0;
+    return true;
+}
+
+std::string WorldStorage::regionPath(const ChunkKey& region) const {
+    return dir + "/r." + std::to_string(region.x) + "." + std::to_string(region.z) + ".bin";
+}
+
+WorldStorage::Region* WorldStorage::regionFor(int chunkX, int chunkZ, bool create) {
+    ChunkKey key{floorDivRegion(chunkX), floorDivRegion(chunkZ)};
+    if (Region* r = regions.find(key)) return r;
+
+    // Layout: magic, then the table of (offset, size) per chunk, then payloads
+    std::string path = regionPath(key);
+    auto file = std::make_unique<std::fstream>(path, std::ios::in | std::ios::out | std::ios::binary);
+    std::vector<Entry> table(REGION_CHUNKS);
+    if (*file) {
+        char magic[4];
+        file->read(magic, sizeof(magic));
+        file->read(reinterpret_cast<char*>(table.data()), table.size() * sizeof(Entry));
+        if (!*file || std::memcmp(magic, REGION_MAGIC, sizeof(magic)) != 0) {
+            std::cerr << "WorldStorage: " << path << " is damaged, ignoring it\n";
+            return nullptr;
+        }
+    } else {
+        if (!create) return nullptr;
+        std::ofstream(path, std::ios::binary).write(REGION_MAGIC, sizeof(REGION_MAGIC))
+            .write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(Entry));
+        file = std::make_unique<std::fstream>(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!*file) {
+            std::cerr << "WorldStorage: can't create " << path << "\n";
+            return nullptr;
+        }
+    }
+    return regions.emplace(key, Region{std::move(file), std::move(table)}).first;
+}
+
+bool WorldStorage::save(int chunkX, int chunkZ, const std::vector<uint8_t>& payload) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (dir.empty()) return false;
+    Region* r = regionFor(chunkX, chunkZ, true);
+    if (!r) return false;
+
+    std::fstream& f = *r->file;
+    f.seekp(0, std::ios::end);
+    Entry e;
+    e.offset = (uint32_t)f.tellp();
+    e.size = (uint32_t)payload.size();
+    f.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    // the table entry goes last, so a failed write leaves the old copy in place
+    size_t i = entryIndex(chunkX, chunkZ);
+    f.seekp(sizeof(REGION_MAGIC) + i * sizeof(Entry));
+    f.write(reinterpret_cast<const char*>(&e), sizeof(e));
+    f.flush();
+    if (!f) {
+        f.clear();
+        std::cerr << "WorldStorage: writing chunk " << chunkX << "," << chunkZ << " failed\n";
+        return false;
+    }
+    r->table[i] = e;
+    bytesWritten += payload.size();
+    return true;
+}
+
+bool WorldStorage::load(int chunkX, int chunkZ, std::vector<uint8_t>& payload) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (dir.empty()) return false;
+    Region* r = regionFor(chunkX, chunkZ, false);
+    if (!r) return false;
+    const Entry& e = r->table[entryIndex(chunkX, chunkZ)];
+    if (e.offset == 0) return false;
+
+    std::fstream& f = *r->file;
+    payload.resize(e.size);
+    f.seekg(e.offset);
+    f.read(reinterpret_cast<char*>(payload.data()), e.size);
+    if (!f) {
+        f.clear();
+        std::cerr << "WorldStorage: reading chunk " << chunkX << "," << chunkZ << " failed\n";
+        return false;
+    }
+    return true;
+}
+
+bool WorldStorage::contains(int chunkX, int chunkZ) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (dir.empty()) return false;
+    Region* r = regionFor(chunkX, chunkZ, false);
+    return r && r->table[entryIndex(chunkX, chunkZ)].offset != 0;
+}
+
+uint64_t WorldStorage::getBytesWritten() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return bytesWritten;
+}
@@ -10,14 +10,13 @@
 #include "Player.h"
 #include "Renderer.h"
 #include "Server.h"
-#include "ChunkManager.h" // for ChunkKey
+#include "ChunkWindow.h"
 
 #include <chrono>
 #include <iostream>
 #include <memory>
 #include <thread>
 #include <vector>
-#include <unordered_map>
 #include <limits>
 
 #include <glm/vec3.hpp>
@@ -60,9 +59,25 @@ static glm::ivec2 chunkCoordsFromPlayer(const Player& player, int chunkSize) {
     return glm::ivec2((int)std::floor(c.x), (int)std::floor(c.z));
 }
 
-// offset a mesh's positions by world translation
-static void offsetMesh(std::vector<Vertex>& verts, const glm::vec3& offset) {
-    for (auto &v : verts) v.pos += offset;
+// A chunk within RENDER_DISTANCE: its blocks, kept so its neighbours' border
+// faces can be tested against them. Its mesh lives in the renderer.
+struct LoadedChunk {
+    ChunkRef chunk;
+    bool dirty = false; // arrived, or a neighbour did, since the last mesh
+};
+
+// mesh a loaded chunk against whichever of its neighbours are loaded
+static void remeshChunk(Renderer& renderer, const ChunkWindow<LoadedChunk>& chunks, const ChunkKey& key,
+                        LoadedChunk& c, MeshMode mode) {
+    auto neighbour = [&](int dx, int dz) -> const Chunk* {
+        const LoadedChunk* n = chunks.get(key.x + dx, key.z + dz);
+        return n ? n->chunk.get() : nullptr;
+    };
+    ChunkNeighbours around{neighbour(-1, 0), neighbour(1, 0), neighbour(0, -1), neighbour(0, 1)};
+    // mesh positions are local to chunk: 0..CHUNK_SIZE-1; the renderer adds the origin
+    renderer.setChunkMesh(key, glm::vec3((float)key.x * (float)CHUNK_SIZE, 0.0f, (float)key.z * (float)CHUNK_SIZE),
+                          buildChunkMesh(*c.chunk, around, mode));
+    c.dirty = false;
 }
 
 int main() {
@@ -119,12 +134,19 @@ int main() {
         std::cerr << "Failed to connect to server — continuing (will show default cube)\n";
     }
 
-    // loadedChunks keyed by chunk index (chunkX, chunkZ)
-    std::unordered_map<ChunkKey, std::vector<Vertex>> loadedChunks;
+    // chunks within RENDER_DISTANCE of the player, by chunk index
+    ChunkWindow<LoadedChunk> loadedChunks(RENDER_DISTANCE);
 
-    // last player chunk so we only rebuild combined mesh when it changes
+    // player is dropped onto the terrain once the chunk under them arrives
+    bool spawnPlaced = false;
+
+    // last player chunk so we only load and remesh when it changes
     glm::ivec2 lastPlayerChunk(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
 
+    // G cycles bitmask -> per-block -> greedy meshing and remeshes everything
+    MeshMode meshMode = MeshMode::Bitmask;
+    bool meshKeyDown = false;
+
     // sky color
     glClearColor(0.529f, 0.808f, 0.922f, 1.0f); // light sky blue
 
@@ -146,51 +168,81 @@ int main() {
         if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) player.camera.processKeyboard(' ', dt);
         if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) player.camera.processKeyboard('X', dt);
 
+        bool meshKey = glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS;
+        if (meshKey && !meshKeyDown) {
+            meshMode = meshMode == MeshMode::Bitmask  ? MeshMode::PerBlock
+                       : meshMode == MeshMode::PerBlock ? MeshMode::Greedy
+                                                        : MeshMode::Bitmask;
+            loadedChunks.forEach([](const ChunkKey&, LoadedChunk& c) { c.dirty = true; });
+            lastPlayerChunk = glm::ivec2(std::numeric_limits<int>::min()); // rebuild this frame
+            std::cout << "Meshing "
+                      << (meshMode == MeshMode::Bitmask    ? "bitmask"
+                          : meshMode == MeshMode::PerBlock ? "per block"
+                                                           : "greedy")
+                      << std::endl;
+        }
+        meshKeyDown = meshKey;
+
         // compute player's current chunk index
         glm::ivec2 playerChunk = chunkCoordsFromPlayer(player, CHUNK_SIZE);
 
         // If player moved into a new chunk, (re)request chunks around them
         if (playerChunk != lastPlayerChunk) {
-            // We keep previously loaded chunks in the map. If you want to unload far chunks,
-            // iterate and remove keys outside the render distance here.
+            // chunks that fell out of the render distance are dropped here
+            std::vector<std::pair<ChunkKey, LoadedChunk>> evicted;
+            loadedChunks.recenter(playerChunk.x, playerChunk.y, &evicted);
+            for (auto& e : evicted) {
+                client.releaseChunk(e.first.x, e.first.z);
+                renderer.removeChunkMesh(e.first);
+                std::cout << "Unloaded chunk [" << e.first.x << "," << e.first.z << "]\n";
+            }
+
             for (int dz = -RENDER_DISTANCE; dz <= RENDER_DISTANCE; ++dz) {
                 for (int dx = -RENDER_DISTANCE; dx <= RENDER_DISTANCE; ++dx) {
                     int cx = playerChunk.x + dx; // chunk index in X
                     int cz = playerChunk.y + dz; // chunk index in Z (we used ivec2: x,y)
-                    ChunkKey key{cx, cz};
-
-                    if (loadedChunks.find(key) != loadedChunks.end()) continue; // already loaded
+                    if (loadedChunks.contains(cx, cz)) continue; // already loaded
 
                     // Request chunk using chunk indices (server expects chunk indices)
                     auto chunkData = client.requestChunk((uint32_t)cx, 0u, (uint32_t)cz);
-                    if (chunkData.blocks.empty()) {
+                    if (!chunkData.chunk) {
                         std::cerr << "Client: empty chunk received for (" << cx << "," << cz << ")\n";
                         continue;
                     }
 
-                    // Build mesh from chunk bytes (mesh positions are local to chunk: 0..CHUNK_SIZE-1)
-                    auto verts = buildChunkMesh(chunkData.blocks.data(), chunkData.width, chunkData.height, chunkData.depth);
+                    // meshed below once this sweep's chunks are in
+                    ChunkRef chunk = std::move(chunkData.chunk);
 
-                    // offset to world coordinates: chunk index * CHUNK_SIZE
-                    glm::vec3 worldOffset((float)cx * (float)CHUNK_SIZE, 0.0f, (float)cz * (float)CHUNK_SIZE);
-                    offsetMesh(verts, worldOffset);
+                    if (!spawnPlaced && dx == 0 && dz == 0) {
+                        int lx = (int)std::floor(player.camera.position.x) - cx * CHUNK_SIZE;
+                        int lz = (int)std::floor(player.camera.position.z) - cz * CHUNK_SIZE;
+                        int top = chunk->getTopHeight(lx, lz);
+                        // block tops sit at y + 0.5; keep the eye a bit above that
+                        if (top >= 0) player.camera.position.y = (float)top + 2.1f;
+                        spawnPlaced = true;
+                    }
 
-                    loadedChunks.emplace(key, std::move(verts));
+                    LoadedChunk* slot = loadedChunks.claim(cx, cz);
+                    slot->chunk = std::move(chunk);
+                    slot->dirty = true;
+                    // faces of loaded neighbours against this chunk may now be hidden
+                    const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+                    for (auto& o : offsets)
+                        if (LoadedChunk* n = loadedChunks.get(cx + o[0], cz + o[1])) n->dirty = true;
                     std::cout << "Loaded chunk [" << cx << "," << cz << "]\n";
                 }
             }
 
-            // combine loaded chunk meshes into one big mesh for renderer
-            std::vector<Vertex> combined;
-            combined.reserve(loadedChunks.size() * 1000); // heuristic reserve
-            for (auto& kv : loadedChunks) {
-                auto& v = kv.second;
-                combined.insert(combined.end(), v.begin(), v.end());
-            }
+            int remeshed = 0;
+            loadedChunks.forEach([&](const ChunkKey& key, LoadedChunk& c) {
+                if (!c.dirty) return;
+                remeshChunk(renderer, loadedChunks, key, c, meshMode);
+                ++remeshed;
+            });
 
-            renderer.setMesh(combined);
             lastPlayerChunk = playerChunk;
-            std::cout << "Rebuilt combined mesh around chunk " << playerChunk.x << ", " << playerChunk.y << std::endl;
+            std::cout << "Remeshed " << remeshed << " chunks around chunk " << playerChunk.x << ", " << playerChunk.y
+                      << std::endl;
         }
 
         // Render
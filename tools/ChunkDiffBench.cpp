@@ -0,0 +1,113 @@
+// tools/ChunkDiffBench.cpp - whole chunks against local generation plus edits
+//
+// Starts a Server on loopback and fetches the same square of chunks with two
+// clients: one that receives whole chunks and one that negotiated local
+// generation and receives only edits. Reports bytes on the wire and time per
+// chunk for both and checks they end up with identical chunks.
+//
+// The server has no way to edit blocks over the network yet, so edits are
+// checked on a ChunkManager directly: random setBlock calls, then the edit
+// list is replayed on a fresh generation of the chunk and compared, and its
+// size is set against the whole chunk.
+// Exits non-zero on a mismatch.
+// Build with `make tools`, run build/tools/ChunkDiffBench.
+
+#include "Client.h"
+#include "ChunkRandom.h"
+#include "Server.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+constexpr uint16_t PORT = 42170;
+constexpr int RADIUS = 4; // 9x9 chunks
+
+struct Fetch {
+    std::vector<ChunkRef> chunks;
+    uint64_t bytes = 0;
+    double usPerChunk = 0.0;
+    bool local = false;
+};
+
+static bool fetch(bool localGeneration, Fetch& out) {
+    Client client;
+    client.setVerbose(false);
+    if (!client.connectToServer("127.0.0.1", PORT, localGeneration)) return false;
+    out.local = client.generatesLocally();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int z = -RADIUS; z <= RADIUS; ++z)
+        for (int x = -RADIUS; x <= RADIUS; ++x) {
+            ChunkData d = client.requestChunk((uint32_t)x, 0u, (uint32_t)z);
+            if (!d.chunk) return false;
+            out.chunks.push_back(std::move(d.chunk));
+        }
+    auto t1 = std::chrono::steady_clock::now();
+    out.bytes = client.getBytesReceived();
+    out.usPerChunk = std::chrono::duration<double, std::micro>(t1 - t0).count() / out.chunks.size();
+    return true;
+}
+
+int main() {
+    // networking logs every chunk; keep the report readable
+    Server server(PORT);
+    server.setVerbose(false);
+    server.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    Fetch whole, local;
+    bool ok = fetch(false, whole) && fetch(true, local);
+    server.stop();
+
+    // random edits: replaying them on a fresh chunk must give the edited one
+    const int counts[] = {1, 16, 256};
+    ChunkManager edited, fresh;
+    size_t editMismatches = 0;
+    std::vector<std::pair<size_t, size_t>> editBytes; // (edits, whole) per count
+    for (int i = 0; i < 3; ++i) {
+        int cx = i, cz = 7;
+        edited.loadChunk(cx, cz);
+        ChunkRandom rng(1337, cx, cz, ChunkRandom::Ores);
+        const int size = edited.getChunkSize();
+        for (int e = 0; e < counts[i]; ++e) {
+            int x = (int)rng.below(4 * e, size), y = (int)rng.below(4 * e + 1, ChunkManager::CHUNK_HEIGHT);
+            int z = (int)rng.below(4 * e + 2, size);
+            Block b{(BlockType)rng.below(4 * e + 3, 5), RampDirection::None};
+            edited.setBlock(cx * size + x, y, cz * size + z, b);
+        }
+        std::vector<BlockEdit> edits;
+        ChunkRef cur = edited.getChunkWithEdits(cx, cz, edits);
+        fresh.loadChunk(cx, cz);
+        Chunk replay = *fresh.getChunk(cx, cz);
+        std::vector<uint8_t> wire = Chunk::serializeEdits(edits);
+        editMismatches += !replay.applyEdits(wire) || replay.serialize() != cur->serialize();
+        editBytes.emplace_back(wire.size(), cur->serialize().size());
+    }
+
+    if (!ok) {
+        std::cout << "couldn't fetch chunks from the server on port " << PORT << "\n";
+        return 1;
+    }
+    size_t chunkMismatches = 0;
+    for (size_t i = 0; i < whole.chunks.size(); ++i) chunkMismatches += whole.chunks[i]->serialize() != local.chunks[i]->serialize();
+
+    const double n = (double)whole.chunks.size();
+    std::cout << whole.chunks.size() << " chunks over loopback\n"
+              << "client              bytes/chunk  us/chunk\n"
+              << std::fixed << std::setprecision(1);
+    for (auto row : {std::make_pair("whole chunks", &whole), std::make_pair("local + edits", &local)})
+        std::cout << std::left << std::setw(18) << row.first << std::right << std::setw(13) << row.second->bytes / n
+                  << std::setw(10) << row.second->usPerChunk << "\n";
+    std::cout << "local generation " << (local.local ? "negotiated" : "NOT negotiated") << ", " << chunkMismatches
+              << " chunk mismatches\n\n"
+              << "edits  edit bytes  whole bytes\n";
+    for (int i = 0; i < 3; ++i)
+        std::cout << std::setw(5) << counts[i] << std::setw(12) << editBytes[i].first << std::setw(13)
+                  << editBytes[i].second << "\n";
+    std::cout << editMismatches << " replay mismatches\n";
+
+    bool pass = local.local && chunkMismatches == 0 && editMismatches == 0;
+    std::cout << (pass ? "ok" : "FAIL") << "\n";
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+// tools/ChunkMapBench.cpp - chunk table lookup microbenchmark
+//
+// Compares ChunkMap against std::unordered_map with the old XOR-multiply
+// ChunkKey hash. The workload mirrors the client: a render-distance square of
+// chunks around a player that walks along x, loading the new edge, unloading
+// the old one and looking up every chunk in the window (plus a ring of misses)
+// each step. Build with `make tools`, run build/tools/ChunkMapBench.
+
+#include "ChunkMap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+
+constexpr int RADIUS = 16;   // 33x33 window
+constexpr int STEPS = 2000;
+
+struct XorChunkKeyHash {
+    size_t operator()(ChunkKey const& k) const noexcept {
+        return (std::hash<int>()(k.x) * 73856093) ^ (std::hash<int>()(k.z) * 19349663);
+    }
+};
+
+struct StdMap {
+    std::unordered_map<ChunkKey, uint32_t, XorChunkKeyHash> m;
+    const uint32_t* find(const ChunkKey& k) const {
+        auto it = m.find(k);
+        return it == m.end() ? nullptr : &it->second;
+    }
+    void insert(const ChunkKey& k, uint32_t v) { m.emplace(k, v); }
+    void erase(const ChunkKey& k) { m.erase(k); }
+    size_t size() const { return m.size(); }
+};
+
+struct FlatMap {
+    ChunkMap<uint32_t> m;
+    const uint32_t* find(const ChunkKey& k) const { return m.find(k); }
+    void insert(const ChunkKey& k, uint32_t v) { m.emplace(k, v); }
+    void erase(const ChunkKey& k) { m.erase(k); }
+    size_t size() const { return m.size(); }
+};
+
+static volatile uint64_t sink;
+
+template <class M>
+static void run(const char* name) {
+    M map;
+    for (int z = -RADIUS; z <= RADIUS; ++z)
+        for (int x = -RADIUS; x <= RADIUS; ++x) map.insert({x, z}, (uint32_t)(x * 31 + z));
+
+    uint64_t acc = 0, lookups = 0, hits = 0;
+    double lookupNs = 0, churnNs = 0;
+    for (int step = 0; step < STEPS; ++step) {
+        int px = step;
+
+        auto t0 = std::chrono::steady_clock::now();
+        // one ring wider than the window so about 1 in 9 lookups misses
+        for (int z = -RADIUS - 1; z <= RADIUS + 1; ++z)
+            for (int x = px - RADIUS - 1; x <= px + RADIUS + 1; ++x) {
+                if (const uint32_t* v = map.find({x, z})) { acc += *v; ++hits; }
+                ++lookups;
+            }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int z = -RADIUS; z <= RADIUS; ++z) {
+            map.erase({px - RADIUS, z});
+            map.insert({px + RADIUS + 1, z}, (uint32_t)step);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        lookupNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        churnNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+    }
+    sink = acc;
+
+    double churnOps = (double)STEPS * (2 * RADIUS + 1) * 2;
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << lookupNs / lookups << std::setw(14) << churnNs / churnOps
+              << "   (" << map.size() << " entries, " << hits << "/" << lookups << " hits)\n";
+}
+
+int main() {
+    std::cout << "ns per operation, " << (2 * RADIUS + 1) << "x" << (2 * RADIUS + 1) << " window, "
+              << STEPS << " steps\n";
+    std::cout << "map                   lookup  insert/erase\n";
+    run<StdMap>("unordered_map");
+    run<FlatMap>("ChunkMap");
+    return 0;
+}
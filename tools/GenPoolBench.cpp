@@ -0,0 +1,49 @@
+// tools/GenPoolBench.cpp - chunk generation throughput against worker count
+//
+// Generates the same square of chunks through a ChunkGenPool with 1, 2, 4, ...
+// workers (up to the hardware thread count) and reports chunks per second and
+// the speedup over one worker. Chunks are requested in scan order but
+// handed out nearest-first around a player at the square's centre.
+// Build with `make tools`, run build/tools/GenPoolBench.
+
+#include "ChunkGenPool.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+constexpr int RADIUS = 8; // 17x17 chunks
+
+static double run(unsigned threads) {
+    ChunkManager manager(16, RADIUS);
+    ChunkGenPool pool(manager, threads);
+    pool.setPlayerChunks({ChunkKey{0, 0}});
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<ChunkHandle> handles;
+    for (int z = -RADIUS; z <= RADIUS; ++z)
+        for (int x = -RADIUS; x <= RADIUS; ++x) handles.push_back(pool.request(x, z));
+    size_t done = 0;
+    for (auto& h : handles) done += h.get() != nullptr;
+    auto t1 = std::chrono::steady_clock::now();
+
+    return done / std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main() {
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    int side = 2 * RADIUS + 1;
+    std::cout << side << "x" << side << " chunks, " << hw << " hardware threads\n";
+    std::cout << "workers   chunks/s   speedup\n";
+    double base = 0.0;
+    for (unsigned t = 1; t <= hw; t *= 2) {
+        double rate = run(t);
+        if (t == 1) base = rate;
+        std::cout << std::setw(7) << t << std::fixed << std::setprecision(1) << std::setw(11) << rate
+                  << std::setprecision(2) << std::setw(9) << rate / base << "x\n";
+        if (t * 2 > hw && t != hw) t = hw / 2; // always finish on hw
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// tools/GoldenHash.cpp - determinism check for world generation
+//
+// Generates a fixed-seed 6x6 chunk region (negative coordinates included)
+// four ways: scan order, reverse order, each chunk in a fresh ChunkManager
+// (so no partly generated neighbour is reused), and through a ChunkGenPool
+// with four workers, reseeding the C library rand() between runs. Each run hashes
+// every voxel's type and ramp in logical (x, y, z) order, so the result does
+// not depend on SectionLayout either, and must match GOLDEN. Exits non-zero
+// on any mismatch.
+//
+// If a change to terrain generation is meant to alter the output, rerun and
+// replace GOLDEN with the printed hash in the same commit.
+// Build with `make tools`, run build/tools/GoldenHash.
+
+#include "ChunkGenPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+constexpr int32_t WORLD_SEED = 1337;
+constexpr int MIN_CHUNK = -3, MAX_CHUNK = 2;
+constexpr uint64_t GOLDEN = 0x5ba0a95986057e84ull;
+
+// FNV-1a
+static void hashByte(uint64_t& h, uint8_t b) {
+    h ^= b;
+    h *= 0x100000001B3ull;
+}
+
+static uint64_t hashChunk(const Chunk& c) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (int x = 0; x < c.getWidth(); ++x)
+        for (int y = 0; y < c.getHeight(); ++y)
+            for (int z = 0; z < c.getDepth(); ++z) {
+                Block b = c.getBlock(x, y, z);
+                hashByte(h, (uint8_t)b.type);
+                hashByte(h, (uint8_t)b.ramp);
+            }
+    return h;
+}
+
+// region hash combined in fixed scan order, whatever order chunks were made in
+static uint64_t hashRegion(ChunkManager& manager) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (int z = MIN_CHUNK; z <= MAX_CHUNK; ++z)
+        for (int x = MIN_CHUNK; x <= MAX_CHUNK; ++x) {
+            ChunkRef c = manager.getChunk(x, z);
+            uint64_t ch = c ? hashChunk(*c) : 0;
+            for (int i = 0; i < 8; ++i) hashByte(h, (uint8_t)(ch >> (8 * i)));
+        }
+    return h;
+}
+
+static uint64_t generateInOrder(bool reverse) {
+    ChunkManager manager;
+    manager.setWorldSeed(WORLD_SEED);
+    std::vector<ChunkKey> keys;
+    for (int z = MIN_CHUNK; z <= MAX_CHUNK; ++z)
+        for (int x = MIN_CHUNK; x <= MAX_CHUNK; ++x) keys.push_back({x, z});
+    if (reverse) std::reverse(keys.begin(), keys.end());
+    for (const ChunkKey& k : keys) manager.loadChunk(k.x, k.z);
+    return hashRegion(manager);
+}
+
+static uint64_t generateAlone() {
+    ChunkManager region;
+    for (int z = MIN_CHUNK; z <= MAX_CHUNK; ++z)
+        for (int x = MIN_CHUNK; x <= MAX_CHUNK; ++x) {
+            ChunkManager alone;
+            alone.setWorldSeed(WORLD_SEED);
+            alone.loadChunk(x, z);
+            region.loadChunkFromData(x, z, 16, 64, 16, alone.serializeChunk(x, z));
+        }
+    return hashRegion(region);
+}
+
+static uint64_t generateOnPool() {
+    ChunkManager manager;
+    manager.setWorldSeed(WORLD_SEED);
+    {
+        ChunkGenPool pool(manager, 4);
+        pool.setPlayerChunks({ChunkKey{MAX_CHUNK, MIN_CHUNK}});
+        std::vector<ChunkHandle> handles;
+        for (int z = MIN_CHUNK; z <= MAX_CHUNK; ++z)
+            for (int x = MIN_CHUNK; x <= MAX_CHUNK; ++x) handles.push_back(pool.request(x, z));
+        for (auto& h : handles) h.wait();
+    }
+    return hashRegion(manager);
+}
+
+int main() {
+    struct Run {
+        const char* name;
+        uint64_t hash;
+    } runs[4];
+    std::srand(1);
+    runs[0] = {"scan order", generateInOrder(false)};
+    std::srand(2);
+    runs[1] = {"reverse order", generateInOrder(true)};
+    std::srand(3);
+    runs[2] = {"chunk alone", generateAlone()};
+    std::srand(4);
+    runs[3] = {"pool, 4 workers", generateOnPool()};
+
+    int side = MAX_CHUNK - MIN_CHUNK + 1;
+    std::cout << side << "x" << side << " chunks, world seed " << WORLD_SEED << ", golden " << std::hex
+              << std::setfill('0') << std::setw(16) << GOLDEN << "\n";
+    bool ok = true;
+    for (const Run& r : runs) {
+        bool match = r.hash == GOLDEN;
+        ok = ok && match;
+        std::cout << std::setfill(' ') << std::left << std::setw(16) << r.name << std::setfill('0') << std::right
+                  << std::setw(16) << r.hash << "  " << (match ? "ok" : "MISMATCH") << "\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// tools/LayoutBench.cpp - compare chunk section memory layouts
+//
+// Runs the access patterns the generator, heightmap/ramp pass and mesher use
+// against a dense 16x64x16 chunk stored in each SectionLayout, and reports
+// nanoseconds per voxel. Build with `make tools`, run build/tools/LayoutBench.
+
+#include "ChunkLayout.h"
+#include "Chunk.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+constexpr int W = 16, H = 64, D = 16;
+constexpr int SH = Chunk::SECTION_HEIGHT;
+constexpr int REPEATS = 400;
+
+template <class L>
+struct DenseChunk {
+    size_t secVol = L::volume(W, SH, D);
+    std::vector<uint8_t> data = std::vector<uint8_t>(secVol * (H / SH), 0);
+
+    size_t at(int x, int y, int z) const {
+        return secVol * (y / SH) + L::index(x, y % SH, z, W, SH, D);
+    }
+    uint8_t get(int x, int y, int z) const { return data[at(x, y, z)]; }
+};
+
+static int surfaceAt(int x, int z) { return 32 + ((x * 7 + z * 13) % 12); }
+
+template <class F>
+static double timeNsPerVoxel(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; ++r) f();
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / ((double)REPEATS * W * H * D);
+}
+
+static volatile uint64_t sink;
+
+template <class L>
+static void run() {
+    DenseChunk<L> c;
+
+    // generator: fill every section in storage order from a column height
+    double fill = timeNsPerVoxel([&] {
+        for (int s = 0; s < H / SH; ++s) {
+            uint8_t* base = c.data.data() + c.secVol * s;
+            L::forEach(W, SH, D, [&](int x, int ly, int z, size_t i) {
+                int y = s * SH + ly, top = surfaceAt(x, z);
+                base[i] = y > top ? 0 : (y == top ? 1 : (y >= top - 2 ? 3 : 2));
+            });
+        }
+    });
+
+    // heightmap / ramp pass: scan each column down from the top
+    double column = timeNsPerVoxel([&] {
+        uint64_t acc = 0;
+        for (int z = 0; z < D; ++z)
+            for (int x = 0; x < W; ++x)
+                for (int y = H - 1; y >= 0; --y) acc += c.get(x, y, z);
+        sink = acc;
+    });
+
+    // mesher: every solid voxel looks at its six neighbours
+    double neighbours = timeNsPerVoxel([&] {
+        uint64_t acc = 0;
+        for (int s = 0; s < H / SH; ++s) {
+            L::forEach(W, SH, D, [&](int x, int ly, int z, size_t) {
+                int y = s * SH + ly;
+                if (!c.get(x, y, z)) return;
+                if (x > 0) acc += c.get(x - 1, y, z);
+                if (x < W - 1) acc += c.get(x + 1, y, z);
+                if (y > 0) acc += c.get(x, y - 1, z);
+                if (y < H - 1) acc += c.get(x, y + 1, z);
+                if (z > 0) acc += c.get(x, y, z - 1);
+                if (z < D - 1) acc += c.get(x, y, z + 1);
+            });
+        }
+        sink = acc;
+    });
+
+    // x, z, y nesting used by the original mesher, independent of layout
+    double xzy = timeNsPerVoxel([&] {
+        uint64_t acc = 0;
+        for (int x = 0; x < W; ++x)
+            for (int z = 0; z < D; ++z)
+                for (int y = 0; y < H; ++y) acc += c.get(x, y, z);
+        sink = acc;
+    });
+
+    std::cout << std::left << std::setw(8) << L::name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << fill << std::setw(10) << column << std::setw(12) << neighbours
+              << std::setw(10) << xzy << "   (" << c.data.size() << " bytes)\n";
+}
+
+int main() {
+    std::cout << "ns per voxel, 16x64x16 chunk, " << REPEATS << " repeats; active layout: "
+              << SectionLayout::name << "\n";
+    std::cout << "layout        fill    column  neighbours   x,z,y\n";
+    run<LinearLayout>();
+    run<ColumnLayout>();
+    run<MortonLayout>();
+    return 0;
+}
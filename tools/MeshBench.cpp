@@ -0,0 +1,184 @@
+// tools/MeshBench.cpp - chunk mesh size and build time
+//
+// Generates a square of chunks and meshes the inner ones, without their
+// neighbours and with them, per block, with column bitmasks and greedily.
+// Reports vertices per chunk against emitting every face of every block,
+// what the same meshes take as plain triangle lists, and the build time.
+// Then checks the per-block meshes against a face-by-face count made with
+// world lookups across chunk borders, and that
+// the bitmask and greedy meshes cover exactly the same block faces with one
+// texture repeat per block.
+// Exits non-zero on a mismatch.
+// Build with `make tools`, run build/tools/MeshBench.
+
+#include "ChunkManager.h"
+#include "ChunkMeshBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+constexpr int RADIUS = 3; // meshes 5x5 chunks, with a ring of neighbours
+
+// One unit face: direction (0..5 as in addCubeMesh) and twice its centre
+using UnitFace = std::array<int, 4>;
+
+// Splits the cube quads of a mesh (the quads before the ramps') into unit
+// faces. Returns false if a quad's uv doesn't run 0..n over its n blocks.
+static bool unitFaces(const std::vector<Vertex>& mesh, size_t cubeVerts, std::vector<UnitFace>& out) {
+    for (size_t q = 0; q < cubeVerts; q += 4) {
+        glm::vec3 p[3] = {mesh[q].getPosition(), mesh[q + 1].getPosition(), mesh[q + 2].getPosition()};
+        glm::vec3 lo = p[0], hi = p[0];
+        glm::vec2 uvLo = mesh[q].getTexCoord(), uvHi = uvLo;
+        for (size_t i = q + 1; i < q + 4; ++i) {
+            lo = glm::min(lo, mesh[i].getPosition());
+            hi = glm::max(hi, mesh[i].getPosition());
+            uvLo = glm::min(uvLo, mesh[i].getTexCoord());
+            uvHi = glm::max(uvHi, mesh[i].getTexCoord());
+        }
+        glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        glm::vec3 ext = hi - lo;
+        int axis = ext.x == 0.0f ? 0 : ext.y == 0.0f ? 1 : 2;
+        int dir = (axis == 0 ? 2 : axis == 1 ? 4 : 0) + (normal[axis] > 0.0f);
+
+        // uv spans the two block counts, in either order
+        glm::vec2 span = uvHi - uvLo, blocks(ext[(axis + 1) % 3], ext[(axis + 2) % 3]);
+        if (uvLo != glm::vec2(0.0f) || !((span == blocks) || (span == glm::vec2(blocks.y, blocks.x)))) return false;
+
+        int c[3];
+        for (c[0] = (int)std::lround(2 * lo.x + (axis != 0)); c[0] <= (int)std::lround(2 * hi.x); c[0] += 2)
+            for (c[1] = (int)std::lround(2 * lo.y + (axis != 1)); c[1] <= (int)std::lround(2 * hi.y); c[1] += 2)
+                for (c[2] = (int)std::lround(2 * lo.z + (axis != 2)); c[2] <= (int)std::lround(2 * hi.z); c[2] += 2)
+                    out.push_back(UnitFace{dir, c[0], c[1], c[2]});
+    }
+    std::sort(out.begin(), out.end());
+    return true;
+}
+
+int main() {
+    ChunkManager manager;
+    const int size = manager.getChunkSize();
+    const int height = ChunkManager::CHUNK_HEIGHT;
+
+    for (int z = -RADIUS; z <= RADIUS; ++z)
+        for (int x = -RADIUS; x <= RADIUS; ++x) manager.loadChunk(x, z);
+
+    auto block = [&](int wx, int y, int wz) {
+        if (y < 0) return Block{BlockType::Stone, RampDirection::None}; // below the world counts as solid
+        if (y >= height) return Block{};
+        int cx = wx >= 0 ? wx / size : (wx + 1) / size - 1, cz = wz >= 0 ? wz / size : (wz + 1) / size - 1;
+        return manager.getChunk(cx, cz)->getBlock(wx - cx * size, y, wz - cz * size);
+    };
+
+    const int inner = RADIUS - 1;
+    const int chunks = (2 * inner + 1) * (2 * inner + 1);
+    size_t allFaces = 0, alone = 0, withNeighbours = 0, bitmask = 0, greedy = 0, expected = 0, mismatched = 0,
+           bitmaskMismatched = 0, greedyMismatched = 0;
+    // the same meshes as triangle lists, six vertices per quad
+    size_t listNeighbours = 0, listGreedy = 0;
+    auto listVerts = [](const ChunkMesh& m) { return m.quads.size() / 4 * 6 + m.triangles.size(); };
+    double usAlone = 0.0, usNeighbours = 0.0, usBitmask = 0.0, usGreedy = 0.0;
+    for (int cz = -inner; cz <= inner; ++cz)
+        for (int cx = -inner; cx <= inner; ++cx) {
+            ChunkRef c = manager.getChunk(cx, cz);
+            ChunkNeighbours around{manager.getChunk(cx - 1, cz).get(), manager.getChunk(cx + 1, cz).get(),
+                                   manager.getChunk(cx, cz - 1).get(), manager.getChunk(cx, cz + 1).get()};
+
+            auto t0 = std::chrono::steady_clock::now();
+            size_t a = buildChunkMesh(*c, {}, MeshMode::PerBlock).vertexCount();
+            auto t1 = std::chrono::steady_clock::now();
+            ChunkMesh perBlock = buildChunkMesh(*c, around, MeshMode::PerBlock);
+            auto t2 = std::chrono::steady_clock::now();
+            ChunkMesh masked = buildChunkMesh(*c, around, MeshMode::Bitmask);
+            auto t3 = std::chrono::steady_clock::now();
+            ChunkMesh merged = buildChunkMesh(*c, around, MeshMode::Greedy);
+            auto t4 = std::chrono::steady_clock::now();
+            usAlone += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            usNeighbours += std::chrono::duration<double, std::micro>(t2 - t1).count();
+            usBitmask += std::chrono::duration<double, std::micro>(t3 - t2).count();
+            usGreedy += std::chrono::duration<double, std::micro>(t4 - t3).count();
+            size_t n = perBlock.vertexCount();
+            alone += a;
+            withNeighbours += n;
+            bitmask += masked.vertexCount();
+            greedy += merged.vertexCount();
+            listNeighbours += listVerts(perBlock);
+            listGreedy += listVerts(merged);
+
+            // every face, and the faces no neighbouring voxel hides, the slow way
+            ChunkMesh rampVerts;
+            for (const RampEntry& r : c->getRamps())
+                addRampMesh(r.dir, c->getBlockType(r.x, r.y, r.z), glm::vec3(r.x, r.y, r.z), rampVerts);
+            size_t cubes = 0, faces = 0;
+            const int d[6][3] = {{0, 0, -1}, {0, 0, 1}, {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}};
+            for (int y = 0; y < height; ++y)
+                for (int z = 0; z < size; ++z)
+                    for (int x = 0; x < size; ++x) {
+                        Block b = c->getBlock(x, y, z);
+                        if (b.type == BlockType::Air || b.ramp != RampDirection::None) continue;
+                        ++cubes;
+                        for (int f = 0; f < 6; ++f) {
+                            Block nb = block(cx * size + x + d[f][0], y + d[f][1], cz * size + z + d[f][2]);
+                            bool hidden = nb.type != BlockType::Air &&
+                                          (nb.ramp == RampDirection::None || f == 5 ||
+                                           (nb.ramp == RampDirection::North && f == 0) ||
+                                           (nb.ramp == RampDirection::South && f == 1) ||
+                                           (nb.ramp == RampDirection::East && f == 3) ||
+                                           (nb.ramp == RampDirection::West && f == 2));
+                            faces += !hidden;
+                        }
+                    }
+            allFaces += cubes * 24 + rampVerts.vertexCount();
+            size_t want = faces * 4 + rampVerts.vertexCount();
+            expected += want;
+            mismatched += n != want;
+
+            // same faces, whatever order they come in and quads they were merged into
+            std::vector<UnitFace> blockFaces;
+            const size_t rampQuads = rampVerts.quads.size();
+            bool uvOk = perBlock.quads.size() >= rampQuads &&
+                        unitFaces(perBlock.quads, perBlock.quads.size() - rampQuads, blockFaces);
+            auto samePos = [](const Vertex& x, const Vertex& y) { return x.pos == y.pos; };
+            auto differs = [&](const ChunkMesh& mesh) {
+                std::vector<UnitFace> faces;
+                return !uvOk || mesh.quads.size() < rampQuads ||
+                       !unitFaces(mesh.quads, mesh.quads.size() - rampQuads, faces) || faces != blockFaces ||
+                       !std::equal(rampVerts.quads.begin(), rampVerts.quads.end(), mesh.quads.end() - rampQuads,
+                                   samePos) ||
+                       !std::equal(rampVerts.triangles.begin(), rampVerts.triangles.end(), mesh.triangles.begin(),
+                                   mesh.triangles.end(), samePos);
+            };
+            bitmaskMismatched += differs(masked);
+            greedyMismatched += differs(merged);
+        }
+
+    std::cout << chunks << " chunks, " << sizeof(Vertex) << "-byte vertices\n"
+              << "mesh                   verts/chunk  of all faces  us/chunk\n"
+              << std::fixed;
+    // us < 0 for a row that wasn't timed
+    auto row = [&](const char* name, size_t verts, double us) {
+        std::cout << std::left << std::setw(22) << name << std::right << std::setprecision(0) << std::setw(13)
+                  << (double)verts / chunks << std::setprecision(2) << std::setw(13) << 100.0 * verts / allFaces
+                  << "%" << std::setprecision(1) << std::setw(10);
+        if (us < 0) std::cout << "-\n";
+        else std::cout << us / chunks << "\n";
+    };
+    row("every face", allFaces, -1.0);
+    row("culled, alone", alone, usAlone);
+    row("culled, neighbours", withNeighbours, usNeighbours);
+    row("bitmask, neighbours", bitmask, usBitmask);
+    row("greedy, neighbours", greedy, usGreedy);
+    std::cout << "as triangle lists: " << std::setprecision(0) << (double)listNeighbours / chunks
+              << " verts/chunk culled, " << (double)listGreedy / chunks << " greedy; indexed quads save "
+              << std::setprecision(1) << 100.0 - 100.0 * withNeighbours / listNeighbours << "%\n";
+    std::cout << mismatched << " chunks differ from the face-by-face count (" << expected / chunks
+              << " verts/chunk)  " << (mismatched ? "FAIL" : "ok") << "\n"
+              << bitmaskMismatched << " bitmask meshes differ from the per-block surface  "
+              << (bitmaskMismatched ? "FAIL" : "ok") << "\n"
+              << greedyMismatched << " greedy meshes differ from the per-block surface  "
+              << (greedyMismatched ? "FAIL" : "ok") << "\n";
+    return mismatched || bitmaskMismatched || greedyMismatched ? 1 : 0;
+}
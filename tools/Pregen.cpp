@@ -0,0 +1,161 @@
+// tools/Pregen.cpp - pregenerate an area into world storage before a server opens
+//
+// Generates every chunk of a square or circle around a centre chunk on all
+// hardware threads, and saves each one to a WorldStorage directory as soon
+// as it is done. Chunks already stored are skipped, so an interrupted run
+// picks up where it stopped. Chunks leave memory once they and all their
+// neighbours in the area are done, so large areas fit.
+//
+// Reports progress, then chunks per second and where the generation time
+// went per stage. Stage times are summed over threads.
+// Build with `make tools` (or `make pregen`), run
+//   build/tools/Pregen [--radius N] [--circle] [--center X Z] [--seed S]
+//                      [--lattice-caves] [--threads N] [--dir PATH]
+// The server reads WORLD_DIR ("world") from its working directory.
+
+#include "ChunkGenPool.h"
+#include "Constants.h"
+#include "WorldStorage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+    int radius = 16;
+    bool circle = false;
+    int centerX = 0, centerZ = 0;
+    int32_t seed = 0;
+    CaveField::Sampling caves = CaveField::Sampling::Exact;
+    unsigned threads = 0;
+    std::string dir = WORLD_DIR;
+};
+
+static bool parse(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        auto has = [&](int n) { return i + n < argc; };
+        if (!std::strcmp(argv[i], "--radius") && has(1)) o.radius = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--circle")) o.circle = true;
+        else if (!std::strcmp(argv[i], "--center") && has(2)) {
+            o.centerX = std::atoi(argv[++i]);
+            o.centerZ = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && has(1)) o.seed = (int32_t)std::strtol(argv[++i], nullptr, 0);
+        else if (!std::strcmp(argv[i], "--lattice-caves")) o.caves = CaveField::Sampling::Lattice;
+        else if (!std::strcmp(argv[i], "--threads") && has(1)) o.threads = (unsigned)std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--dir") && has(1)) o.dir = argv[++i];
+        else return false;
+    }
+    return o.radius >= 0;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse(argc, argv, opt)) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--radius N] [--circle] [--center X Z] [--seed S] [--lattice-caves] [--threads N]"
+                     " [--dir PATH]\n";
+        return 2;
+    }
+
+    ChunkManager manager;
+    manager.setWorldSeed(opt.seed);
+    manager.setCaveSampling(opt.caves);
+    WorldStorage storage;
+    if (!storage.open(opt.dir, opt.seed, manager.getChunkSize(), ChunkManager::CHUNK_HEIGHT, opt.caves)) return 1;
+
+    // the area, nearest the centre first, the order the pool hands it out in
+    const int r = opt.radius;
+    const int side = 2 * r + 1;
+    auto inArea = [&](int dx, int dz) {
+        return std::abs(dx) <= r && std::abs(dz) <= r && (!opt.circle || dx * dx + dz * dz <= r * r);
+    };
+    std::vector<ChunkKey> area;
+    for (int dz = -r; dz <= r; ++dz)
+        for (int dx = -r; dx <= r; ++dx)
+            if (inArea(dx, dz)) area.push_back(ChunkKey{dx, dz});
+    std::stable_sort(area.begin(), area.end(), [](const ChunkKey& a, const ChunkKey& b) {
+        return a.x * a.x + a.z * a.z < b.x * b.x + b.z * b.z;
+    });
+
+    // how many chunks of each chunk's 3x3 in the area aren't stored yet; at 0
+    // no ramp needs its surface any more and it can leave memory
+    std::vector<uint8_t> waiting((size_t)side * side, 0);
+    auto cell = [&](int dx, int dz) { return (size_t)(dx + r) + (size_t)side * (dz + r); };
+    for (const ChunkKey& k : area)
+        for (int nz = -1; nz <= 1; ++nz)
+            for (int nx = -1; nx <= 1; ++nx)
+                if (inArea(k.x + nx, k.z + nz)) ++waiting[cell(k.x, k.z)];
+
+    std::cout << "pregenerating " << area.size() << " chunks (" << (opt.circle ? "circle" : "square")
+              << " of radius " << r << " around " << opt.centerX << "," << opt.centerZ << ", seed " << opt.seed
+              << ") into " << opt.dir << "\n";
+
+    auto t0 = std::chrono::steady_clock::now();
+    ChunkGenPool pool(manager, opt.threads);
+    pool.setPlayerChunks({ChunkKey{opt.centerX, opt.centerZ}});
+
+    std::vector<ChunkHandle> handles(area.size());
+    size_t skipped = 0;
+    for (size_t i = 0; i < area.size(); ++i) {
+        if (storage.contains(opt.centerX + area[i].x, opt.centerZ + area[i].z)) ++skipped;
+        else handles[i] = pool.request(opt.centerX + area[i].x, opt.centerZ + area[i].z);
+    }
+
+    size_t generated = 0, failed = 0;
+    double storeSeconds = 0.0;
+    auto lastReport = t0;
+    for (size_t i = 0; i < area.size(); ++i) {
+        const ChunkKey& k = area[i];
+        if (handles[i].valid()) {
+            ChunkRef c = handles[i].get();
+            auto s0 = std::chrono::steady_clock::now();
+            if (!c || !storage.save(opt.centerX + k.x, opt.centerZ + k.z, c->serialize())) ++failed;
+            else ++generated;
+            storeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - s0).count();
+        }
+        for (int nz = -1; nz <= 1; ++nz)
+            for (int nx = -1; nx <= 1; ++nx)
+                if (inArea(k.x + nx, k.z + nz) && --waiting[cell(k.x + nx, k.z + nz)] == 0)
+                    manager.unloadChunk(opt.centerX + k.x + nx, opt.centerZ + k.z + nz);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            lastReport = now;
+            double s = std::chrono::duration<double>(now - t0).count();
+            std::cout << "  " << i + 1 << "/" << area.size() << " chunks, " << std::fixed << std::setprecision(1)
+                      << generated / s << " chunks/s\n"
+                      << std::flush;
+        }
+    }
+    pool.stop();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << std::fixed << std::setprecision(2) << generated << " chunks generated and stored in " << seconds
+              << " s on " << pool.getThreadCount() << " threads: " << std::setprecision(1) << generated / seconds
+              << " chunks/s";
+    if (skipped) std::cout << ", " << skipped << " already stored";
+    if (failed) std::cout << ", " << failed << " FAILED";
+    std::cout << "\n"
+              << storage.getBytesWritten() / 1024 << " KB written\n\n";
+
+    // every stage run, including those on neighbours just outside the area
+    static const char* const names[GEN_STAGE_COUNT] = {"empty", "heightmap", "carve", "surface", "ramps"};
+    ChunkPipeline::StageTimes times = manager.getStageTimes();
+    double total = storeSeconds * 1e3;
+    for (int s = 0; s < GEN_STAGE_COUNT; ++s) total += times.nanos[s] / 1e6;
+    std::cout << "stage       runs   thread ms  us/run  share\n";
+    auto row = [&](const char* name, uint64_t runs, double ms) {
+        std::cout << std::left << std::setw(10) << name << std::right << std::setw(7) << runs << std::setw(12)
+                  << std::setprecision(1) << ms << std::setw(8) << (runs ? 1e3 * ms / runs : 0.0) << std::setw(6)
+                  << std::setprecision(1) << (total > 0 ? 100.0 * ms / total : 0.0) << "%\n";
+    };
+    for (int s = 1; s < GEN_STAGE_COUNT; ++s) row(names[s], times.runs[s], times.nanos[s] / 1e6);
+    row("store", generated, storeSeconds * 1e3);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+// tools/PregenBench.cpp - idle-time pregeneration against a walking player
+//
+// Simulates a player who crosses into a new chunk every STEP_MS, walking
+// east and then turning north. On every step the render square is
+// requested the way Server does it, and the time until all of it is ready
+// is the stall the player would see. The rest of the step is idle time,
+// which the pool spends on PregenPlanner's targets when pregeneration is
+// on. Reports stalls with and without pregeneration, and with it under a
+// small memory cap, and how many requests pregeneration turned into cache
+// hits. Exits non-zero if unclaimed chunks end up over the cap.
+// Build with `make tools`, run build/tools/PregenBench.
+
+#include "ChunkGenPool.h"
+#include "PregenPlanner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+constexpr int STEP_MS = 200;
+constexpr int EAST_STEPS = 12, NORTH_STEPS = 6;
+constexpr size_t SMALL_CAP = 1u << 20;
+
+struct WalkResult {
+    double totalStallMs = 0.0, worstStallMs = 0.0;
+    int steps = 0;
+    ChunkGenPool::PregenStats pregen;
+};
+
+// at least two workers: a pool of one keeps its only worker for requests
+static unsigned workerCount() { return std::max(2u, std::thread::hardware_concurrency()); }
+
+static WalkResult walk(bool pregen, size_t cap = ChunkGenPool::PREGEN_MEMORY_CAP) {
+    ChunkManager manager(16, 4);
+    ChunkGenPool pool(manager, workerCount());
+    pool.setPregenMemoryCap(cap);
+    PregenPlanner planner;
+    const int rd = manager.getRenderDistance();
+    WalkResult result;
+
+    ChunkKey pc{0, 0};
+    for (int step = 0; step <= EAST_STEPS + NORTH_STEPS; ++step) {
+        if (step > 0) {
+            if (step <= EAST_STEPS) ++pc.x;
+            else --pc.z;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        pool.setPlayerChunks({pc});
+        std::vector<ChunkHandle> handles;
+        for (int dx = -rd; dx <= rd; ++dx)
+            for (int dz = -rd; dz <= rd; ++dz) handles.push_back(pool.request(pc.x + dx, pc.z + dz));
+        if (pregen) pool.setPregenTargets(planner.update(pc, rd));
+        for (auto& h : handles) h.wait();
+        auto t1 = std::chrono::steady_clock::now();
+
+        double stall = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        // the first square is a cold start either way
+        if (step > 0) {
+            result.totalStallMs += stall;
+            result.worstStallMs = std::max(result.worstStallMs, stall);
+            ++result.steps;
+        }
+        std::this_thread::sleep_until(t0 + std::chrono::milliseconds(STEP_MS));
+    }
+    result.pregen = pool.getPregenStats();
+    return result;
+}
+
+int main() {
+    WalkResult off = walk(false);
+    WalkResult on = walk(true);
+    WalkResult capped = walk(true, SMALL_CAP);
+
+    std::cout << EAST_STEPS + NORTH_STEPS << " steps of " << STEP_MS << " ms, " << workerCount() << " workers\n"
+              << "pregen   mean stall ms  worst ms  pregenerated  hits  early  evicted  unclaimed KB\n";
+    for (auto row : {std::make_pair("off", off), std::make_pair("on", on), std::make_pair("on, 1MB", capped)}) {
+        const WalkResult& r = row.second;
+        std::cout << std::left << std::setw(7) << row.first << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(15) << r.totalStallMs / r.steps << std::setw(10) << r.worstStallMs << std::setw(14)
+                  << r.pregen.generated << std::setw(6) << r.pregen.hits << std::setw(7) << r.pregen.early
+                  << std::setw(9) << r.pregen.evicted << std::setw(14) << r.pregen.unclaimedBytes / 1024 << "\n";
+    }
+    bool ok = capped.pregen.unclaimedBytes <= SMALL_CAP;
+    std::cout << "unclaimed chunks " << (ok ? "within" : "OVER") << " the 1 MB cap  " << (ok ? "ok" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
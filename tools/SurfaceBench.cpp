@@ -0,0 +1,81 @@
+// tools/SurfaceBench.cpp - surface-only generation against full chunks
+//
+// Times ChunkManager::generateSurface for single chunks and for 4x4-chunk
+// regions against full generation with loadChunk (which also generates the
+// ring of neighbours its ramps need), per chunk. Then checks every column
+// of the fully generated chunks against the surface: same height and top
+// type, or one higher with a ramp on top. Exits non-zero on a mismatch.
+// Build with `make tools`, run build/tools/SurfaceBench.
+
+#include "ChunkManager.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+constexpr int RADIUS = 4; // 8x8 chunks, a multiple of the 4x4 region
+
+static volatile int sink;
+
+template <class F>
+static double usPerChunk(int chunks, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / chunks;
+}
+
+int main() {
+    const int side = 2 * RADIUS;
+    const int chunks = side * side;
+    ChunkManager manager;
+    const int size = manager.getChunkSize();
+
+    double full = usPerChunk(chunks, [&] {
+        for (int z = -RADIUS; z < RADIUS; ++z)
+            for (int x = -RADIUS; x < RADIUS; ++x) manager.loadChunk(x, z);
+    });
+
+    // repeat the cheap paths so the timer resolution doesn't matter
+    const int repeats = 20;
+    double single = usPerChunk(chunks * repeats, [&] {
+        for (int r = 0; r < repeats; ++r)
+            for (int z = -RADIUS; z < RADIUS; ++z)
+                for (int x = -RADIUS; x < RADIUS; ++x) sink = manager.generateSurface(x, z).height[0];
+    });
+    double region = usPerChunk(chunks * repeats, [&] {
+        for (int r = 0; r < repeats; ++r)
+            for (int z = -RADIUS; z < RADIUS; z += 4)
+                for (int x = -RADIUS; x < RADIUS; x += 4) sink = manager.generateSurface(x, z, 4).height[0];
+    });
+
+    std::cout << side << "x" << side << " chunks\n"
+              << "path               us/chunk  fraction of full\n"
+              << std::fixed << std::setprecision(1) << std::left << std::setw(17) << "full (loadChunk)"
+              << std::right << std::setw(10) << full << "\n";
+    for (auto row : {std::make_pair("surface 1x1", single), std::make_pair("surface 4x4", region)})
+        std::cout << std::left << std::setw(17) << row.first << std::right << std::setprecision(1) << std::setw(10)
+                  << row.second << std::setprecision(2) << std::setw(17) << 100.0 * row.second / full << "%\n";
+
+    // the whole area as one surface, against what loadChunk produced
+    ChunkSurface surface = manager.generateSurface(-RADIUS, -RADIUS, side);
+    size_t columns = 0, ramps = 0, mismatches = 0;
+    for (int cz = -RADIUS; cz < RADIUS; ++cz)
+        for (int cx = -RADIUS; cx < RADIUS; ++cx) {
+            ChunkRef c = manager.getChunk(cx, cz);
+            for (int z = 0; z < size; ++z)
+                for (int x = 0; x < size; ++x) {
+                    size_t i = (size_t)((cx + RADIUS) * size + x) + (size_t)side * size * ((cz + RADIUS) * size + z);
+                    int top = c->getTopHeight(x, z);
+                    Block b = c->getBlock(x, top, z);
+                    bool ramp = b.ramp != RampDirection::None;
+                    ramps += ramp;
+                    ++columns;
+                    mismatches += ramp ? top != surface.height[i] + 1
+                                       : top != surface.height[i] || b.type != surface.top[i];
+                }
+        }
+    std::cout << columns << " columns checked, " << ramps << " with a ramp on top, " << mismatches
+              << " mismatches  " << (mismatches ? "FAIL" : "ok") << "\n";
+    return mismatches ? 1 : 0;
+}
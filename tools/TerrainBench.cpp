@@ -0,0 +1,218 @@
+// tools/TerrainBench.cpp - terrain generation benchmark and accuracy check
+//
+// Times the batched height noise for every HeightNoise path on a single
+// 16x16 chunk grid and a 64x64 region (4x4 chunks), and compares each path
+// against the FastNoiseLite scalar path over a spread of chunks, including
+// negative coordinates. The generic path isolates what the compile-time
+// kernel gains without SIMD. Exits non-zero if any sample differs by more
+// than HeightNoise::TOLERANCE.
+//
+// It then times exact cave sampling through FastNoiseLite and through the
+// compile-time kernel, which must agree to the same tolerance, and compares
+// exact sampling with the interpolated CaveField lattice (the default
+// spacing and a coarser 4x2x4 one) over 8x8 chunks: time per cave-candidate
+// voxel, noise evaluations, how many voxels change between cave and solid,
+// and whether two chunks sharing a border agree there.
+// Build with `make tools`, run build/tools/TerrainBench.
+
+#include "HeightNoise.h"
+#include "CaveField.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+constexpr int CHUNK = 16;
+constexpr int HEIGHT = 64;
+constexpr int WORLD_SEED = 0;
+
+static volatile float sink;
+
+template <class F>
+static double timeNs(int repeats, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) f(r);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / repeats;
+}
+
+// ns per column for w x d grids at shifting origins
+static double timeGrid(HeightNoise::Simd simd, int w, int d, bool heights) {
+    std::vector<float> noise((size_t)w * d);
+    std::vector<int> top((size_t)w * d);
+    int repeats = 2000000 / (w * d);
+    double ns = timeNs(repeats, [&](int r) {
+        int ox = (r % 64 - 32) * w, oz = (r / 64 % 64 - 32) * d;
+        if (heights) HeightNoise::fillHeights(WORLD_SEED, ox, oz, w, d, HEIGHT, top.data(), simd);
+        else HeightNoise::sample(WORLD_SEED, ox, oz, w, d, noise.data(), simd);
+        sink = noise[0] + (float)top[0];
+    });
+    return ns / (w * d);
+}
+
+// largest |path - scalar| and number of surface heights that differ
+static bool checkAccuracy(HeightNoise::Simd simd) {
+    float maxDiff = 0.0f;
+    size_t samples = 0, heightDiffs = 0;
+    std::vector<float> ref(CHUNK * CHUNK), got(CHUNK * CHUNK);
+    std::vector<int> refTop(CHUNK * CHUNK), gotTop(CHUNK * CHUNK);
+    for (int cz = -20; cz < 20; ++cz) {
+        for (int cx = -20; cx < 20; ++cx) {
+            HeightNoise::sample(WORLD_SEED, cx * CHUNK, cz * CHUNK, CHUNK, CHUNK, ref.data(), HeightNoise::Simd::Scalar);
+            HeightNoise::sample(WORLD_SEED, cx * CHUNK, cz * CHUNK, CHUNK, CHUNK, got.data(), simd);
+            HeightNoise::fillHeights(WORLD_SEED, cx * CHUNK, cz * CHUNK, CHUNK, CHUNK, HEIGHT, refTop.data(), HeightNoise::Simd::Scalar);
+            HeightNoise::fillHeights(WORLD_SEED, cx * CHUNK, cz * CHUNK, CHUNK, CHUNK, HEIGHT, gotTop.data(), simd);
+            for (size_t i = 0; i < ref.size(); ++i) {
+                maxDiff = std::max(maxDiff, std::fabs(ref[i] - got[i]));
+                heightDiffs += refTop[i] != gotTop[i];
+            }
+            samples += ref.size();
+        }
+    }
+    // an odd-sized region exercises the partial last vector of each row
+    std::vector<float> oddRef(37 * 23), oddGot(37 * 23);
+    HeightNoise::sample(WORLD_SEED, -300, 117, 37, 23, oddRef.data(), HeightNoise::Simd::Scalar);
+    HeightNoise::sample(WORLD_SEED, -300, 117, 37, 23, oddGot.data(), simd);
+    for (size_t i = 0; i < oddRef.size(); ++i) maxDiff = std::max(maxDiff, std::fabs(oddRef[i] - oddGot[i]));
+    samples += oddRef.size();
+
+    bool ok = maxDiff <= HeightNoise::TOLERANCE;
+    std::cout << std::left << std::setw(8) << HeightNoise::name(simd) << std::right << std::scientific
+              << std::setprecision(2) << "  max |diff| " << maxDiff << " over " << samples << " samples, "
+              << heightDiffs << " surface heights differ  " << (ok ? "ok" : "FAIL") << "\n"
+              << std::defaultfloat;
+    return ok;
+}
+
+struct CaveRun {
+    double ns = 0.0;
+    size_t voxels = 0, caves = 0, samples = 0;
+};
+
+// Carve every candidate voxel (below surface - 3) of an 8x8 chunk area
+static CaveRun runCaves(CaveField::Sampling sampling, int latticeXZ, int latticeY, std::vector<float>* densities,
+                        CaveField::Kernel kernel = CaveField::Kernel::Fixed) {
+    CaveRun run;
+    std::vector<int> top(CHUNK * CHUNK);
+    for (int cz = -4; cz < 4; ++cz) {
+        for (int cx = -4; cx < 4; ++cx) {
+            HeightNoise::fillHeights(WORLD_SEED, cx * CHUNK, cz * CHUNK, CHUNK, CHUNK, HEIGHT, top.data());
+            int maxTop = *std::max_element(top.begin(), top.end());
+            auto t0 = std::chrono::steady_clock::now();
+            CaveField field(WORLD_SEED, cx * CHUNK, cz * CHUNK, CHUNK, CHUNK, maxTop - 4, sampling, latticeXZ, latticeY,
+                            kernel);
+            for (int z = 0; z < CHUNK; ++z)
+                for (int x = 0; x < CHUNK; ++x)
+                    for (int y = 0; y < top[x + CHUNK * z] - 3; ++y) {
+                        float v = field.density(x, y, z);
+                        run.caves += v > CaveField::THRESHOLD;
+                        ++run.voxels;
+                        if (densities) densities->push_back(v);
+                    }
+            auto t1 = std::chrono::steady_clock::now();
+            run.ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            run.samples += field.getSampleCount();
+        }
+    }
+    return run;
+}
+
+// Lattice of the given spacing against exact sampling
+static bool checkCaves(const CaveRun& e, const std::vector<float>& exact, int latticeXZ, int latticeY) {
+    CaveRun l = runCaves(CaveField::Sampling::Lattice, latticeXZ, latticeY, nullptr);
+    std::vector<float> lattice;
+    runCaves(CaveField::Sampling::Lattice, latticeXZ, latticeY, &lattice);
+
+    size_t flipped = 0;
+    double sumDiff = 0.0;
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < exact.size(); ++i) {
+        float diff = std::fabs(exact[i] - lattice[i]);
+        sumDiff += diff;
+        maxDiff = std::max(maxDiff, diff);
+        flipped += (exact[i] > CaveField::THRESHOLD) != (lattice[i] > CaveField::THRESHOLD);
+    }
+
+    // a field for two chunks side by side must match each chunk's own field
+    bool seamless = true;
+    auto field = [&](int originX, int w) {
+        return CaveField(WORLD_SEED, originX, 3 * CHUNK, w, CHUNK, 40, CaveField::Sampling::Lattice, latticeXZ, latticeY);
+    };
+    CaveField pair = field(-CHUNK, 2 * CHUNK), left = field(-CHUNK, CHUNK), right = field(0, CHUNK);
+    for (int z = 0; z < CHUNK; ++z)
+        for (int y = 0; y <= 40; ++y)
+            for (int x = 0; x < CHUNK; ++x)
+                seamless = seamless && pair.density(x, y, z) == left.density(x, y, z) &&
+                           pair.density(CHUNK + x, y, z) == right.density(x, y, z);
+
+    std::ostringstream label;
+    label << "lattice " << latticeXZ << "x" << latticeY << "x" << latticeXZ;
+    std::cout << std::left << std::setw(16) << label.str() << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << l.ns / l.voxels << std::setw(10) << l.samples << std::setw(9) << l.caves
+              << std::setw(9) << e.ns / l.ns << "x" << std::setprecision(4) << std::setw(10)
+              << sumDiff / exact.size() << std::setw(8) << maxDiff << std::setprecision(2) << std::setw(9)
+              << 100.0 * flipped / exact.size() << "%  " << (seamless ? "seamless" : "NOT SEAMLESS") << "\n";
+    return seamless;
+}
+
+int main() {
+    const HeightNoise::Simd paths[] = {HeightNoise::Simd::Scalar, HeightNoise::Simd::Generic,
+                                       HeightNoise::Simd::SSE41, HeightNoise::Simd::AVX2};
+    HeightNoise::Simd best = HeightNoise::detect();
+    std::cout << "height noise, detected path: " << HeightNoise::name(best) << "\n";
+
+    std::cout << "ns per column     noise 16x16  noise 64x64  heights 16x16  heights 64x64\n";
+    double scalarChunk = 0.0;
+    for (HeightNoise::Simd simd : paths) {
+        if (simd > best) continue;
+        double n16 = timeGrid(simd, CHUNK, CHUNK, false);
+        double n64 = timeGrid(simd, 4 * CHUNK, 4 * CHUNK, false);
+        double h16 = timeGrid(simd, CHUNK, CHUNK, true);
+        double h64 = timeGrid(simd, 4 * CHUNK, 4 * CHUNK, true);
+        if (simd == HeightNoise::Simd::Scalar) scalarChunk = h16;
+        std::cout << std::left << std::setw(16) << HeightNoise::name(simd) << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(13) << n16 << std::setw(13) << n64 << std::setw(15) << h16
+                  << std::setw(15) << h64 << "   (" << scalarChunk / h16 << "x per chunk)\n";
+    }
+
+    std::cout << "accuracy against the FastNoiseLite scalar path (tolerance " << std::scientific
+              << std::setprecision(0) << HeightNoise::TOLERANCE << std::defaultfloat << ")\n";
+    bool ok = true;
+    for (HeightNoise::Simd simd : paths) {
+        if (simd == HeightNoise::Simd::Scalar || simd > best) continue;
+        ok = checkAccuracy(simd) && ok;
+    }
+
+    // exact timing first, then an untimed pass that keeps every density
+    CaveRun runtimeRun = runCaves(CaveField::Sampling::Exact, 0, 0, nullptr, CaveField::Kernel::Runtime);
+    std::vector<float> runtime;
+    runCaves(CaveField::Sampling::Exact, 0, 0, &runtime, CaveField::Kernel::Runtime);
+    CaveRun exactRun = runCaves(CaveField::Sampling::Exact, 0, 0, nullptr);
+    std::vector<float> exact;
+    runCaves(CaveField::Sampling::Exact, 0, 0, &exact);
+
+    float kernelDiff = 0.0f;
+    for (size_t i = 0; i < exact.size(); ++i) kernelDiff = std::max(kernelDiff, std::fabs(exact[i] - runtime[i]));
+    bool kernelOk = kernelDiff <= HeightNoise::TOLERANCE;
+    ok = kernelOk && ok;
+
+    std::cout << "caves over 8x8 chunks; diff and flipped (cave <-> solid) are against exact sampling,\n"
+              << "and for exact itself against FastNoiseLite\n"
+              << "sampling        ns/voxel  samples   caves  speedup  mean|diff| max|diff|  flipped\n"
+              << std::left << std::setw(16) << "exact fastnoise" << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << runtimeRun.ns / runtimeRun.voxels << std::setw(10) << runtimeRun.samples
+              << std::setw(9) << runtimeRun.caves << "\n"
+              << std::left << std::setw(16) << "exact" << std::right << std::setw(8)
+              << exactRun.ns / exactRun.voxels << std::setw(10) << exactRun.samples << std::setw(9)
+              << exactRun.caves << std::setw(9) << runtimeRun.ns / exactRun.ns << "x" << std::setw(18)
+              << std::scientific << std::setprecision(1) << kernelDiff << std::defaultfloat << "  "
+              << (kernelOk ? "ok" : "FAIL") << "\n";
+    ok = checkCaves(exactRun, exact, CaveField::LATTICE_XZ, CaveField::LATTICE_Y) && ok;
+    ok = checkCaves(exactRun, exact, 4, 2) && ok;
+    return ok ? 0 : 1;
+}